@@ -0,0 +1,6 @@
+varying vec4 vColor;
+
+void main()
+{
+	gl_FragColor = vColor;
+};
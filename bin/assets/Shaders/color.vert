@@ -0,0 +1,11 @@
+uniform mat3 uMtxMVP;
+attribute vec2 aPosition;
+attribute vec4 aColor;
+
+varying vec4 vColor;
+
+void main()
+{
+	gl_Position = vec4(uMtxMVP * vec3(aPosition.x, aPosition.y, 1.0), 1.0);
+	vColor = aColor;
+};
@@ -0,0 +1,138 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "Arena.h"
+#include "Log.h"
+#include <cassert>
+#include <algorithm>
+
+Arena::Arena(size_t blockSize)
+{
+	_cursor = nullptr;
+	_remaining = 0;
+	_blockSize = blockSize;
+	_bytesReserved = 0;
+	_bytesInUse = 0;
+
+	for(auto &head : _freeLists)
+		head = nullptr;
+}
+
+Arena::~Arena()
+{
+	// blocks are released all at once, nothing is freed per object
+}
+
+void *Arena::_allocateBlock(size_t size)
+{
+	unique_ptr<unsigned char[]> block(new unsigned char[size + Granularity]);
+
+	// new[] only guarantees alignment for fundamental types
+	uintptr_t addr = (uintptr_t)block.get();
+	addr = (addr + Granularity - 1) & ~(uintptr_t)(Granularity - 1);
+
+	_blocks.push_back(move(block));
+	_bytesReserved += size + Granularity;
+
+	return (void*)addr;
+}
+
+void *Arena::allocate(size_t size, size_t alignment)
+{
+	assert(alignment <= Granularity);
+
+	lock_guard<mutex> lk(_lock);
+
+	size = (max(size, (size_t)1) + Granularity - 1) & ~(Granularity - 1);
+	_bytesInUse += size;
+
+	FreeNode **head = nullptr;
+
+	if(size <= MaxPooledSize)
+	{
+		head = &_freeLists[size / Granularity - 1];
+	}
+	else
+	{
+		auto it = _largeFreeLists.find(size);
+
+		if(it != _largeFreeLists.end())
+			head = &it->second;
+	}
+
+	if(head && *head)
+	{
+		FreeNode *node = *head;
+		*head = node->next;
+		return node;
+	}
+
+	if(size > _blockSize / 4)
+		return _allocateBlock(size);
+
+	if(size > _remaining)
+	{
+		_cursor = (unsigned char*)_allocateBlock(_blockSize);
+		_remaining = _blockSize;
+	}
+
+	void *ret = _cursor;
+	_cursor += size;
+	_remaining -= size;
+
+	return ret;
+}
+
+void Arena::deallocate(void *p, size_t size)
+{
+	if(!p)
+		return;
+
+	lock_guard<mutex> lk(_lock);
+
+	size = (max(size, (size_t)1) + Granularity - 1) & ~(Granularity - 1);
+	_bytesInUse -= size;
+
+	FreeNode *node = (FreeNode*)p;
+	FreeNode *&head = size <= MaxPooledSize ? _freeLists[size / Granularity - 1] : _largeFreeLists[size];
+	node->next = head;
+	head = node;
+}
+
+bool Arena::Release()
+{
+	lock_guard<mutex> lk(_lock);
+
+	if(_bytesInUse != 0)
+	{
+		Log(LogLevel::Error, LogCategory::Resources, "Arena released with bytes still in use", (unsigned int)_bytesInUse);
+		assert(!"objects allocated from a released arena are still alive");
+		return false;
+	}
+
+	_blocks.clear();
+	_cursor = nullptr;
+	_remaining = 0;
+	_bytesReserved = 0;
+
+	for(auto &head : _freeLists)
+		head = nullptr;
+
+	_largeFreeLists.clear();
+
+	return true;
+}
+
+size_t Arena::bytesReserved() const
+{
+	lock_guard<mutex> lk(_lock);
+	return _bytesReserved;
+}
+
+size_t Arena::bytesInUse() const
+{
+	lock_guard<mutex> lk(_lock);
+	return _bytesInUse;
+}
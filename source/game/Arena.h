@@ -0,0 +1,110 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+
+// Block allocator for objects that share a lifetime, like everything a level
+// creates. Freed memory is recycled through a free list per rounded size, and
+// blocks are only given back all at once, by Release() or when the arena goes
+// away. Objects are freed from pool threads and loaders too, so allocations
+// take a lock.
+class Arena
+{
+	static const size_t Granularity = 16;
+	static const size_t MaxPooledSize = 1024;
+	static const size_t SizeClassCount = MaxPooledSize / Granularity;
+
+	struct FreeNode {
+		FreeNode *next;
+	};
+
+	vector<unique_ptr<unsigned char[]>> _blocks;
+	unsigned char *_cursor;
+	size_t _remaining;
+	size_t _blockSize;
+	size_t _bytesReserved;
+	size_t _bytesInUse;
+	FreeNode *_freeLists[SizeClassCount];
+	unordered_map<size_t, FreeNode*> _largeFreeLists; // over MaxPooledSize
+	mutable mutex _lock;
+
+	void *_allocateBlock(size_t size);
+
+public:
+	Arena(size_t blockSize = 256 * 1024);
+	~Arena();
+
+	Arena(const Arena&) = delete;
+	Arena &operator=(const Arena&) = delete;
+
+	void *allocate(size_t size, size_t alignment);
+	void deallocate(void *p, size_t size);
+
+	// gives every block back now. Nothing allocated from the arena may still
+	// be alive; if something is, it is logged and asserted, the blocks are
+	// kept, and it returns false.
+	bool Release();
+
+	size_t bytesReserved() const;
+	size_t bytesInUse() const;
+};
+
+// Standard allocator over an Arena, for allocate_shared and containers. Every
+// copy keeps the Arena object alive, its memory is released by the Engine
+// when the state that owns it is removed.
+template<class T>
+class ArenaAllocator
+{
+public:
+	typedef T value_type;
+
+	template<class U>
+	struct rebind {
+		typedef ArenaAllocator<U> other;
+	};
+
+	shared_ptr<Arena> arena;
+
+	ArenaAllocator(const shared_ptr<Arena> &arena) : arena(arena){}
+
+	template<class U>
+	ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena){}
+
+	T *allocate(size_t n) {
+		return (T*)arena->allocate(n * sizeof(T), alignof(T));
+	}
+
+	void deallocate(T *p, size_t n) {
+		arena->deallocate(p, n * sizeof(T));
+	}
+
+	template<class U>
+	bool operator==(const ArenaAllocator<U> &other) const {
+		return arena == other.arena;
+	}
+
+	template<class U>
+	bool operator!=(const ArenaAllocator<U> &other) const {
+		return arena != other.arena;
+	}
+};
+
+// make_shared from 'arena', or from the heap when there isn't one
+template<class T, class... Args>
+shared_ptr<T> make_pooled(const shared_ptr<Arena> &arena, Args&&... args)
+{
+	if(arena)
+		return allocate_shared<T>(ArenaAllocator<T>(arena), std::forward<Args>(args)...);
+	else
+		return make_shared<T>(std::forward<Args>(args)...);
+}
@@ -6,12 +6,15 @@
 #include "Audio.h"
 #include <AL/al.h>
 #include <AL/alc.h>
+#include "Log.h"
+#include <algorithm>
 
 Audio::Audio()
 {
 	device = NULL;
 	context = NULL;
 	alive = false;
+	_output = AudioOutput::Device;
 }
 
 Audio::~Audio()
@@ -19,18 +22,34 @@ Audio::~Audio()
 	_terminate();
 }
 
-bool Audio::_initialize()
+bool Audio::_initialize(AudioOutput output, const string &filename)
 {
 	{
-		unique_lock<mutex>(m);
+		unique_lock<recursive_mutex> lk(m);
 
 		// open the audio device
-		device = alcOpenDevice(NULL);
+		if(output == AudioOutput::Device)
+		{
+			device = alcOpenDevice(NULL);
+
+			if(!device)
+			{
+				Log(LogLevel::Warning, LogCategory::Audio, "no audio device, mixing to a null output");
+				output = AudioOutput::Null;
+			}
+		}
+
+		if(output != AudioOutput::Device)
+			device = _loopback.Open(output, filename);
+
 		if(!device)
 			return false;
 
+		_output = output;
+
 		// create a context
-		context = alcCreateContext(device, NULL);
+		const ALCint *attrs = output != AudioOutput::Device ? LoopbackOutput::contextAttributes() : NULL;
+		context = alcCreateContext(device, attrs);
 		alcMakeContextCurrent(context);
 	
 		// clear error code
@@ -41,10 +60,20 @@ bool Audio::_initialize()
 
 		ALfloat orientation[] = {0.0, 0.0, -1.0, 0.0, 1.0, 0.0};
 		alListenerfv(AL_ORIENTATION, orientation);
+
+		_voices.Create();
 	}
 
 	alive = true;
 
+	if(_output != AudioOutput::Device)
+	{
+		_loopback.Start([this]{
+			unique_lock<recursive_mutex> lk(m);
+			return _playingCount();
+		});
+	}
+
 
 
 	return true;
@@ -55,9 +84,18 @@ void Audio::_terminate()
 	if(alive)
 	{
 		{
-			unique_lock<mutex>(m);
+			_loopback.Stop();
+
+			unique_lock<recursive_mutex> lk(m);
+			_voices.Destroy();
+
+			alcMakeContextCurrent(NULL);
 			alcDestroyContext(context);
-			alcCloseDevice(device);
+
+			if(_output == AudioOutput::Device)
+				alcCloseDevice(device);
+			else
+				_loopback.Close();
 
 			context = NULL;
 			device = NULL;
@@ -67,9 +105,39 @@ void Audio::_terminate()
 	}
 }
 
-bool Audio::Initialize()
+int Audio::_playingCount()
 {
-	return that->_initialize();
+	// music is mixed like any voice, so it counts towards the per-voice cost
+	int count = _voices.activeCount();
+
+	for(ALuint source : _streamSources)
+	{
+		ALint state;
+		alGetSourcei(source, AL_SOURCE_STATE, &state);
+
+		if(state == AL_PLAYING)
+			++count;
+	}
+
+	return count;
+}
+
+void Audio::_addStream(ALuint source)
+{
+	unique_lock<recursive_mutex> lk(that->m);
+	that->_streamSources.push_back(source);
+}
+
+void Audio::_removeStream(ALuint source)
+{
+	unique_lock<recursive_mutex> lk(that->m);
+	auto &sources = that->_streamSources;
+	sources.erase(remove(sources.begin(), sources.end(), source), sources.end());
+}
+
+bool Audio::Initialize(AudioOutput output, const string &filename)
+{
+	return that->_initialize(output, filename);
 }
 
 void Audio::Terminate()
@@ -82,7 +150,27 @@ bool Audio::Alive()
 	return that->alive;
 }
 
-unique_lock<mutex> Audio::GetLock()
+unique_lock<recursive_mutex> Audio::GetLock()
+{
+	return unique_lock<recursive_mutex>(that->m);
+}
+
+VoicePool &Audio::voices()
+{
+	return that->_voices;
+}
+
+AudioOutput Audio::output()
+{
+	return that->_output;
+}
+
+MixStats Audio::mixStats()
+{
+	return that->_loopback.stats();
+}
+
+void Audio::ResetMixStats()
 {
-	return unique_lock<mutex>(that->m);
+	that->_loopback.ResetStats();
 }
@@ -6,13 +6,15 @@
 #pragma once
 #include <mutex>
 #include <memory>
+#include <vector>
 #include "Singleton.h"
 #include "Stream.h"
 #include "Sound.h"
+#include "VoicePool.h"
+#include "AudioOutput.h"
 
 using namespace std;
 
-typedef struct ALCdevice_struct ALCdevice;
 typedef struct ALCcontext_struct ALCcontext;
 
 class Audio : public Singleton<Audio>
@@ -22,21 +24,39 @@ private:
 	ALCdevice *device;
 	ALCcontext *context;
 	bool alive;
-	mutex m;
+	recursive_mutex m;
+	VoicePool _voices;
+	vector<ALuint> _streamSources; // of every open Stream
+	AudioOutput _output;
+	LoopbackOutput _loopback;
 
 	friend class Engine;
 	friend class Sound;
 	friend class Stream;
 
-	bool _initialize();
+	bool _initialize(AudioOutput output, const string &filename);
 	void _terminate();
+	int _playingCount();
+	static void _addStream(ALuint source);
+	static void _removeStream(ALuint source);
 public:
 
 	Audio();
 	~Audio();
 
-	static bool Initialize();
+	// Null and WaveFile mix in software, without an audio device. Device falls
+	// back to Null when no device can be opened.
+	static bool Initialize(AudioOutput output = AudioOutput::Device, const string &filename = "");
 	static void Terminate();
 	static bool Alive();
-	static unique_lock<mutex> GetLock();
+	static unique_lock<recursive_mutex> GetLock();
+
+	// sources shared by every Sound
+	static VoicePool &voices();
+
+	static AudioOutput output();
+
+	// mixing cost, only measured for the software outputs
+	static MixStats mixStats();
+	static void ResetMixStats();
 };
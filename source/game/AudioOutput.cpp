@@ -0,0 +1,188 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "AudioOutput.h"
+#include "Log.h"
+#include <AL/al.h>
+#include <AL/alc.h>
+#include <AL/alext.h>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+LoopbackOutput::LoopbackOutput()
+{
+	_device = nullptr;
+	_render = nullptr;
+	_running = false;
+	_dataBytes = 0;
+}
+
+LoopbackOutput::~LoopbackOutput()
+{
+	Close();
+}
+
+const int *LoopbackOutput::contextAttributes()
+{
+	static const ALCint attrs[] = {
+		ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT,
+		ALC_FORMAT_TYPE_SOFT, ALC_FLOAT_SOFT,
+		ALC_FREQUENCY, SampleRate,
+		0
+	};
+
+	return attrs;
+}
+
+ALCdevice *LoopbackOutput::Open(AudioOutput output, const string &filename)
+{
+	Close();
+
+	if(!alcIsExtensionPresent(nullptr, "ALC_SOFT_loopback"))
+	{
+		Log(LogLevel::Warning, LogCategory::Audio, "ALC_SOFT_loopback is not supported");
+		return nullptr;
+	}
+
+	auto openDevice = (LPALCLOOPBACKOPENDEVICESOFT)alcGetProcAddress(nullptr, "alcLoopbackOpenDeviceSOFT");
+	_render = (void*)alcGetProcAddress(nullptr, "alcRenderSamplesSOFT");
+
+	if(!openDevice || !_render)
+		return nullptr;
+
+	_device = openDevice(nullptr);
+	if(!_device)
+		return nullptr;
+
+	if(output == AudioOutput::WaveFile)
+	{
+		_file.open(filename, ios_base::binary | ios_base::trunc);
+
+		if(!_file.is_open())
+			Log(LogLevel::Error, LogCategory::Audio, "could not open file", filename);
+		else
+			_writeWaveHeader();
+	}
+
+	return _device;
+}
+
+void LoopbackOutput::Close()
+{
+	Stop();
+
+	if(_file.is_open())
+	{
+		// patch the sizes now that the length is known
+		_file.seekp(0);
+		_writeWaveHeader();
+		_file.close();
+	}
+
+	if(_device)
+	{
+		alcCloseDevice(_device);
+		_device = nullptr;
+	}
+
+	_render = nullptr;
+	_dataBytes = 0;
+}
+
+void LoopbackOutput::_writeWaveHeader()
+{
+	uint16_t format = 3; // IEEE float
+	uint16_t channels = Channels;
+	uint32_t rate = SampleRate;
+	uint16_t blockAlign = Channels * sizeof(float);
+	uint32_t byteRate = rate * blockAlign;
+	uint16_t bits = 32;
+	uint32_t fmtSize = 16;
+	uint32_t riffSize = 4 + (8 + fmtSize) + (8 + _dataBytes);
+
+	_file.write("RIFF", 4);
+	_file.write((char*)&riffSize, 4);
+	_file.write("WAVE", 4);
+	_file.write("fmt ", 4);
+	_file.write((char*)&fmtSize, 4);
+	_file.write((char*)&format, 2);
+	_file.write((char*)&channels, 2);
+	_file.write((char*)&rate, 4);
+	_file.write((char*)&byteRate, 4);
+	_file.write((char*)&blockAlign, 2);
+	_file.write((char*)&bits, 2);
+	_file.write("data", 4);
+	_file.write((char*)&_dataBytes, 4);
+}
+
+void LoopbackOutput::Start(function<int()> activeVoices)
+{
+	if(!_device || _running)
+		return;
+
+	_activeVoices = move(activeVoices);
+	_running = true;
+	_thread = thread([this]{ _renderLoop(); });
+}
+
+void LoopbackOutput::Stop()
+{
+	_running = false;
+
+	if(_thread.joinable())
+		_thread.join();
+}
+
+void LoopbackOutput::_renderLoop()
+{
+	typedef chrono::high_resolution_clock clock;
+
+	auto render = (LPALCRENDERSAMPLESSOFT)_render;
+	vector<float> block(BlockFrames * Channels);
+
+	auto period = chrono::duration_cast<clock::duration>(chrono::duration<double>((double)BlockFrames / SampleRate));
+	auto deadline = clock::now();
+
+	while(_running)
+	{
+		int voices = _activeVoices ? _activeVoices() : 0;
+
+		auto start = clock::now();
+		render(_device, block.data(), BlockFrames);
+		double seconds = chrono::duration<double>(clock::now() - start).count();
+
+		{
+			lock_guard<mutex> lk(_statsMutex);
+			_stats.blocks++;
+			_stats.frames += BlockFrames;
+			_stats.mixSeconds += seconds;
+			_stats.peakBlockSeconds = max(_stats.peakBlockSeconds, seconds);
+			_stats.voiceBlocks += voices;
+		}
+
+		if(_file.is_open())
+		{
+			uint32_t bytes = (uint32_t)(block.size() * sizeof(float));
+			_file.write((char*)block.data(), bytes);
+			_dataBytes += bytes;
+		}
+
+		deadline += period;
+		this_thread::sleep_until(deadline);
+	}
+}
+
+MixStats LoopbackOutput::stats()
+{
+	lock_guard<mutex> lk(_statsMutex);
+	return _stats;
+}
+
+void LoopbackOutput::ResetStats()
+{
+	lock_guard<mutex> lk(_statsMutex);
+	_stats = MixStats();
+}
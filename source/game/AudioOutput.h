@@ -0,0 +1,86 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <fstream>
+#include <functional>
+#include <cstdint>
+
+using namespace std;
+
+typedef struct ALCdevice_struct ALCdevice;
+
+enum class AudioOutput
+{
+	Device,     // the default playback device
+	Null,       // mixed in software and discarded
+	WaveFile    // mixed in software and written to a 32-bit float WAV file
+};
+
+struct MixStats
+{
+	MixStats() : blocks(0), frames(0), mixSeconds(0), peakBlockSeconds(0), voiceBlocks(0){}
+
+	uint64_t blocks;
+	uint64_t frames;
+	double mixSeconds;
+	double peakBlockSeconds;
+	uint64_t voiceBlocks; // sum of the playing voices and streams over every block
+
+	double secondsPerBlock() const {
+		return blocks ? mixSeconds / blocks : 0.0;
+	}
+
+	double secondsPerVoiceBlock() const {
+		return voiceBlocks ? mixSeconds / voiceBlocks : 0.0;
+	}
+};
+
+// Renders an OpenAL-Soft loopback device (ALC_SOFT_loopback) from a thread of
+// its own, so sources are mixed by OpenAL's own mixer without any hardware.
+// Blocks are paced in real time so streams refill the same way they would on
+// a device.
+class LoopbackOutput
+{
+public:
+	static const int SampleRate = 44100;
+	static const int Channels = 2;
+	static const int BlockFrames = 1024;
+
+	LoopbackOutput();
+	~LoopbackOutput();
+
+	// opens the loopback device. Pass contextAttributes() to alcCreateContext.
+	ALCdevice *Open(AudioOutput output, const string &filename);
+	void Close();
+
+	static const int *contextAttributes();
+
+	// activeVoices is sampled once per block for the per-voice cost
+	void Start(function<int()> activeVoices);
+	void Stop();
+
+	MixStats stats();
+	void ResetStats();
+
+private:
+	ALCdevice *_device;
+	void *_render; // alcRenderSamplesSOFT
+	thread _thread;
+	atomic<bool> _running;
+	ofstream _file;
+	uint32_t _dataBytes;
+	function<int()> _activeVoices;
+
+	mutex _statsMutex;
+	MixStats _stats;
+
+	void _renderLoop();
+	void _writeWaveHeader();
+};
@@ -5,8 +5,8 @@
 
 #include "Camera.h"
 #include "Shader.h"
+#include "EngineContext.h"
 
-weak_ptr<Camera> Camera::_activeCamera;
 
 Camera::Camera()
 {
@@ -175,12 +175,12 @@ const mat3f &Camera::matrix() const
 
 shared_ptr<Camera> Camera::activeCamera()
 {
-	return _activeCamera.lock();
+	return EngineContext::current()->activeCamera.lock();
 }
 
 void Camera::activeCamera(const shared_ptr<Camera> &camera)
 {
-	_activeCamera = camera;
+	EngineContext::current()->activeCamera = camera;
 }
 
 float Camera::viewBorder() const
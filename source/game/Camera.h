@@ -48,14 +48,13 @@ public:
 	
 	const mat3f &matrix() const;
 
+	// per EngineContext
 	static shared_ptr<Camera> activeCamera();
 	static void activeCamera(const shared_ptr<Camera> &camera);
 
 	float viewBorder() const;
 	void viewBorder(float setViewBorder);
 private:
-	static weak_ptr<Camera> _activeCamera;
-
 	void Init();
 	
 	float camSpeed; // make sure this is faster than max player/car speed
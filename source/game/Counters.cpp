@@ -0,0 +1,268 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "Counters.h"
+#include "Time.h"
+#include "Trace.h"
+#include <sstream>
+#include <cstdio>
+
+thread_local Counters::ShardLease Counters::_lease;
+
+Counters::ShardLease::~ShardLease()
+{
+	if(shard)
+	{
+		lock_guard<mutex> lk(that->_lock);
+		that->_freeShards.push_back(shard);
+	}
+}
+
+Counters::Counters()
+{
+	_count = 0;
+	_json = false;
+	_interval = 0;
+	_frames = 0;
+	_frameNumber = 0;
+
+	for(auto &base : _base)
+		base = 0;
+}
+
+Counters::~Counters()
+{
+}
+
+int Counters::Register(const string &name, Kind kind)
+{
+	lock_guard<mutex> lk(that->_lock);
+
+	for(size_t i = 0; i < that->_names.size(); ++i)
+	{
+		if(that->_names[i] == name)
+			return (int)i;
+	}
+
+	if(that->_names.size() == MaxCounters)
+	{
+		Trace("Too many counters, ignoring", name);
+		return -1;
+	}
+
+	that->_names.push_back(name);
+	that->_kinds.push_back(kind);
+	that->_count = (int)that->_names.size();
+
+	return (int)that->_names.size() - 1;
+}
+
+Counters::Shard *Counters::_acquireShard()
+{
+	lock_guard<mutex> lk(_lock);
+
+	if(!_freeShards.empty())
+	{
+		Shard *shard = _freeShards.back();
+		_freeShards.pop_back();
+		return shard;
+	}
+
+	_shards.emplace_back(new Shard());
+
+	for(auto &value : _shards.back()->values)
+		value = 0;
+
+	return _shards.back().get();
+}
+
+void Counters::Add(int id, int64_t value)
+{
+	if(id < 0)
+		return;
+
+	Shard *shard = _lease.shard;
+
+	if(!shard)
+		shard = _lease.shard = that->_acquireShard();
+
+	// only this thread writes to its shard
+	auto &counter = shard->values[id];
+	counter.store(counter.load(memory_order_relaxed) + value, memory_order_relaxed);
+}
+
+void Counters::Set(int id, int64_t value)
+{
+	if(id < 0)
+		return;
+
+	lock_guard<mutex> lk(that->_lock);
+
+	int64_t added = 0;
+
+	for(auto &shard : that->_shards)
+		added += shard->values[id].load(memory_order_relaxed);
+
+	that->_base[id] = value - added;
+}
+
+int64_t Counters::total(int id)
+{
+	if(id < 0)
+		return 0;
+
+	lock_guard<mutex> lk(that->_lock);
+
+	int64_t sum = that->_base[id];
+
+	for(auto &shard : that->_shards)
+		sum += shard->values[id].load(memory_order_relaxed);
+
+	return sum;
+}
+
+int Counters::count()
+{
+	return that->_count;
+}
+
+string Counters::name(int id)
+{
+	lock_guard<mutex> lk(that->_lock);
+	return that->_names[id];
+}
+
+bool Counters::StartDump(const string &filename, int interval)
+{
+	StopDump();
+
+	that->_file.open(filename, ios::out | ios::trunc);
+
+	if(!that->_file)
+	{
+		Trace("Couldn't open counter dump", filename);
+		return false;
+	}
+
+	size_t dot = filename.find_last_of('.');
+	that->_json = dot != string::npos && filename.substr(dot) == ".json";
+	that->_interval = interval > 0 ? interval : 1;
+	that->_frames = 0;
+	that->_frameNumber = 0;
+
+	// the first row only counts what happens from here on
+	vector<string> names;
+	vector<Kind> kinds;
+	that->_snapshot(names, kinds, that->_lastTotals);
+
+	// rows are "frame,time,name,value" so counters registered later, like
+	// the classes of objects created mid-game, don't break the header
+	if(!that->_json)
+		that->_file << "frame,time,counter,value\n";
+
+	return true;
+}
+
+void Counters::StopDump()
+{
+	if(that->_file.is_open())
+		that->_file.close();
+
+	that->_interval = 0;
+}
+
+bool Counters::dumping()
+{
+	return that->_interval > 0;
+}
+
+void Counters::EndFrame()
+{
+	if(!dumping())
+		return;
+
+	++that->_frameNumber;
+
+	if(++that->_frames >= that->_interval)
+	{
+		that->_writeRow();
+		that->_frames = 0;
+	}
+}
+
+void Counters::_snapshot(vector<string> &names, vector<Kind> &kinds, vector<int64_t> &totals)
+{
+	lock_guard<mutex> lk(_lock);
+
+	names = _names;
+	kinds = _kinds;
+	totals.assign(_base, _base + names.size());
+
+	for(auto &shard : _shards)
+	{
+		for(size_t i = 0; i < totals.size(); ++i)
+			totals[i] += shard->values[i].load(memory_order_relaxed);
+	}
+}
+
+void Counters::_writeRow()
+{
+	vector<string> names;
+	vector<Kind> kinds;
+	vector<int64_t> totals;
+
+	_snapshot(names, kinds, totals);
+
+	_lastTotals.resize(names.size(), 0);
+
+	double time = Time::time();
+	char value[64];
+
+	if(_json)
+		_file << "{\"frame\":" << _frameNumber << ",\"time\":" << time << ",\"counters\":{";
+
+	for(size_t i = 0; i < names.size(); ++i)
+	{
+		// counters are averaged over the frames since the last row
+		if(kinds[i] == Kind::Counter)
+		{
+			snprintf(value, sizeof(value), "%.2f", (double)(totals[i] - _lastTotals[i]) / (double)_frames);
+			_lastTotals[i] = totals[i];
+		}
+		else
+		{
+			snprintf(value, sizeof(value), "%lld", (long long)totals[i]);
+		}
+
+		if(_json)
+			_file << (i ? "," : "") << "\"" << names[i] << "\":" << value;
+		else
+			_file << _frameNumber << "," << time << "," << names[i] << "," << value << "\n";
+	}
+
+	if(_json)
+		_file << "}}\n";
+
+	_file.flush();
+}
+
+void Counters::Configure(const string &commandLine)
+{
+	istringstream args(commandLine);
+	string arg;
+	string filename;
+	int interval = 60;
+
+	while(args >> arg)
+	{
+		if(arg == "-counters")
+			args >> filename;
+		else if(arg == "-counter-interval")
+			args >> interval;
+	}
+
+	if(!filename.empty())
+		StartDump(filename, interval);
+}
@@ -0,0 +1,113 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include "Singleton.h"
+
+using namespace std;
+
+// Named runtime counters. Every thread adds into its own shard, so Add() is a
+// plain store to memory no other thread writes. Shards are only summed when
+// the counters are read, which is when a dump row is written.
+//
+// A Counter reports how much was added per frame, a Gauge reports its current
+// value, e.g. +1 when something is created and -1 when it's destroyed.
+class Counters : public Singleton<Counters>
+{
+public:
+	enum class Kind
+	{
+		Counter,
+		Gauge
+	};
+
+	static const int MaxCounters = 256;
+
+	Counters();
+	~Counters();
+
+	// registering the same name again returns the same id. Returns -1 once
+	// MaxCounters are registered, which Add() and Set() ignore.
+	static int Register(const string &name, Kind kind);
+
+	static void Add(int id, int64_t value = 1);
+
+	// gauges only, anything added afterwards is added on top
+	static void Set(int id, int64_t value);
+
+	static int64_t total(int id);
+	static int count();
+	static string name(int id);
+
+	// writes a row every 'interval' frames to 'filename', as one JSON object
+	// per line if it ends in .json and as CSV otherwise
+	static bool StartDump(const string &filename, int interval);
+	static void StopDump();
+	static bool dumping();
+
+	// called by the engine once per frame, on the main thread
+	static void EndFrame();
+
+	// handles "-counters <file> [-counter-interval N]" anywhere on the command line
+	static void Configure(const string &commandLine);
+
+private:
+	struct Shard
+	{
+		atomic<int64_t> values[MaxCounters];
+	};
+
+	// gives the shard back when its thread exits. The values stay in it, so
+	// the totals are unchanged and the next thread continues from them.
+	struct ShardLease
+	{
+		Shard *shard;
+		ShardLease() : shard(nullptr){}
+		~ShardLease();
+	};
+
+	static thread_local ShardLease _lease;
+
+	mutex _lock;
+	vector<unique_ptr<Shard>> _shards;
+	vector<Shard*> _freeShards;
+	vector<string> _names;
+	vector<Kind> _kinds;
+	atomic<int> _count;
+	atomic<int64_t> _base[MaxCounters];
+
+	ofstream _file;
+	bool _json;
+	int _interval;
+	int _frames;
+	uint64_t _frameNumber;
+	vector<int64_t> _lastTotals;
+
+	Shard *_acquireShard();
+	void _snapshot(vector<string> &names, vector<Kind> &kinds, vector<int64_t> &totals);
+	void _writeRow();
+};
+
+// a counter registered once, usually kept as a static next to the code that
+// updates it
+class Counter
+{
+	int _id;
+public:
+	Counter(const char *name, Counters::Kind kind = Counters::Kind::Counter)
+		: _id(Counters::Register(name, kind)){}
+
+	void Add(int64_t value = 1) { Counters::Add(_id, value); }
+	void Set(int64_t value) { Counters::Set(_id, value); }
+	int64_t total() const { return Counters::total(_id); }
+	int id() const { return _id; }
+};
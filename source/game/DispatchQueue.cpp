@@ -0,0 +1,141 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "DispatchQueue.h"
+#include "Time.h"
+
+DispatchQueue::DispatchQueue()
+	: _posted(nullptr), _pending(nullptr), _pendingTail(nullptr), _pendingCount(0)
+{
+}
+
+DispatchQueue::~DispatchQueue()
+{
+	Clear();
+}
+
+void DispatchQueue::Post(const function<void()> &fx)
+{
+	Node *node = new Node{ fx, nullptr };
+	_push(node, node);
+}
+
+void DispatchQueue::Post(vector<function<void()>> &&batch)
+{
+	if(batch.empty())
+		return;
+
+	// linked newest first, like the posted list
+	Node *first = nullptr;
+	Node *last = nullptr;
+
+	for(auto &fx : batch)
+	{
+		first = new Node{ move(fx), first };
+
+		if(!last)
+			last = first;
+	}
+
+	batch.clear();
+	_push(first, last);
+}
+
+void DispatchQueue::_push(Node *first, Node *last)
+{
+	Node *head = _posted.load(memory_order_relaxed);
+
+	do
+	{
+		last->next = head;
+	}
+	while(!_posted.compare_exchange_weak(head, first, memory_order_release, memory_order_relaxed));
+}
+
+void DispatchQueue::_take()
+{
+	Node *node = _posted.exchange(nullptr, memory_order_acquire);
+
+	if(!node)
+		return;
+
+	// reverse into posting order before appending
+	Node *first = nullptr;
+	Node *last = node;
+	size_t count = 0;
+
+	while(node)
+	{
+		Node *next = node->next;
+		node->next = first;
+		first = node;
+		node = next;
+		++count;
+	}
+
+	if(_pendingTail)
+		_pendingTail->next = first;
+	else
+		_pending = first;
+
+	_pendingTail = last;
+	_pendingCount += count;
+}
+
+size_t DispatchQueue::Run(float budget)
+{
+	_take();
+
+	long long start = Time::ticks();
+	long long limit = (long long)((double)budget * (double)Time::frequency());
+	size_t ran = 0;
+
+	while(_pending)
+	{
+		Node *node = _pending;
+		_pending = node->next;
+
+		if(!_pending)
+			_pendingTail = nullptr;
+
+		--_pendingCount;
+
+		// functions may post more, those wait for the next call
+		node->fx();
+		delete node;
+		++ran;
+
+		if(budget > 0 && Time::ticks() - start >= limit)
+			break;
+	}
+
+	return ran;
+}
+
+size_t DispatchQueue::count()
+{
+	_take();
+	return _pendingCount;
+}
+
+void DispatchQueue::Clear()
+{
+	_take();
+	_free(_pending);
+
+	_pending = nullptr;
+	_pendingTail = nullptr;
+	_pendingCount = 0;
+}
+
+void DispatchQueue::_free(Node *node)
+{
+	while(node)
+	{
+		Node *next = node->next;
+		delete node;
+		node = next;
+	}
+}
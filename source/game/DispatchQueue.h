@@ -0,0 +1,56 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <atomic>
+#include <functional>
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+// Work posted from any thread and run by one consumer thread, in the order
+// it was posted from each thread. Post() is a single compare-and-swap on the
+// head of a list, and a batch is linked up first and posted with one.
+//
+// Run() takes everything posted so far and runs it until 'budget' seconds
+// have passed. Whatever is left runs first on the next call.
+class DispatchQueue
+{
+	struct Node
+	{
+		function<void()> fx;
+		Node *next;
+	};
+
+	atomic<Node*> _posted;   // newest first
+	Node *_pending;          // oldest first, consumer only
+	Node *_pendingTail;
+	size_t _pendingCount;
+
+	void _push(Node *first, Node *last);
+	void _take();
+	static void _free(Node *node);
+
+public:
+	DispatchQueue();
+	~DispatchQueue();
+
+	DispatchQueue(const DispatchQueue&) = delete;
+	DispatchQueue &operator=(const DispatchQueue&) = delete;
+
+	void Post(const function<void()> &fx);
+	void Post(vector<function<void()>> &&batch);
+
+	// consumer only. At least one function runs if any were posted, a budget
+	// of zero or less runs all of them. Returns how many ran.
+	size_t Run(float budget = 0);
+
+	// consumer only, the number of functions Run() would find
+	size_t count();
+
+	// consumer only, drops everything without running it
+	void Clear();
+};
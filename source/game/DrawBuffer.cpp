@@ -4,6 +4,7 @@
 *--------------------------------------------------------------------------------------------*/
 
 #include "DrawBuffer.h"
+#include "Graphics.h"
 
 DrawBuffer::DrawBuffer()
 {
@@ -15,8 +16,7 @@ DrawBuffer::DrawBuffer()
 
 DrawBuffer::~DrawBuffer()
 {
-	if(glIsBuffer(_hBuffer))
-		glDeleteBuffers(1, &_hBuffer);
+	ClearData();
 }
 
 void DrawBuffer::SetData(const void *data, uint32_t size, Type type, bool dynamic)
@@ -34,7 +34,7 @@ void DrawBuffer::SetData(const void *data, uint32_t size, Type type, bool dynami
 		GLenum bufferType = bufferTypes[(int)_type];
 
 		glGenBuffers(1, &_hBuffer);
-		glBindBuffer(bufferType, _hBuffer);
+		Graphics::state().BindBuffer(bufferType, _hBuffer);
 
 		glBufferData(bufferType, size, nullptr, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
 
@@ -44,8 +44,6 @@ void DrawBuffer::SetData(const void *data, uint32_t size, Type type, bool dynami
 			memcpy(p, data, size);
 			glUnmapBuffer(bufferType);
 		}
-
-		glBindBuffer(bufferType, 0);
 	}
 }
 
@@ -56,16 +54,18 @@ void DrawBuffer::UpdateData(const void *data, uint32_t offset, uint32_t size)
 		GLenum bufferTypes[3] = { 0, GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER };
 		GLenum bufferType = bufferTypes[(int)_type];
 
-		glBindBuffer(bufferType, _hBuffer);
+		Graphics::state().BindBuffer(bufferType, _hBuffer);
 		glBufferSubData(bufferType, offset, size, data);
-		glBindBuffer(bufferType, 0);
 	}
 }
 
 void DrawBuffer::ClearData()
 {
 	if(glIsBuffer(_hBuffer))
+	{
+		Graphics::state().InvalidateBuffer(_hBuffer);
 		glDeleteBuffers(1, &_hBuffer);
+	}
 
 	_hBuffer = -1;
 	_type = Type::None;
@@ -13,12 +13,23 @@
 #include "WindowsApp.h"
 #include <time.h>
 #include "RenderQueue.h"
+#include "ThreadPool.h"
+#include "Random.h"
+#include "Profiler.h"
+#include "Counters.h"
+#include "Log.h"
+#include "Replay.h"
+
+static Counter audioVoices("audio.voices", Counters::Kind::Gauge);
+static Counter postedRun("engine.posted");
+
+thread_local Engine *Engine::_frameEngine = nullptr;
 
 Engine::Engine()
 {
 	quit = false;
 	pApp = nullptr;
-	srand((unsigned int)time(NULL));
+	_postBudget = 0.004f;
 }
 
 Engine::~Engine()
@@ -29,19 +40,32 @@ Engine::~Engine()
 void Engine::Initialize(WindowsApp *pApp)
 {
 	that->pApp = pApp;
-	Audio::Initialize();
+	_frameEngine = that;
+
+	// other contexts keep their own Random, seeded by whoever creates them
+	Random::Seed((uint64_t)time(NULL));
+
+	PROFILE_THREAD("Main");
+	ThreadPool::Initialize();
+	Audio::Initialize(pApp->audioOutput);
 	Graphics::Initialize(pApp->hWnd);
+	Replay::Begin();
 }
 
 void Engine::Terminate()
 {
 	that->tasks.clear();
+	that->_posted.Clear();
 	
 	while(!that->states.empty())
-		that->states.pop();
+		that->_removeTopState();
 
 	Graphics::Destroy();
 	Audio::Terminate();
+	ThreadPool::Terminate();
+	Replay::StopRecording();
+	Counters::StopDump();
+	Logger::Flush();
 
 	that->quit = false;
 	that->pApp = nullptr;
@@ -52,16 +76,51 @@ bool Engine::Update()
 	return that->_update();
 }
 
-bool Engine::_update()
+bool Engine::Simulate()
 {
+	// replays, profiler frames and counter dumps belong to the windowed game
 	Time::Step();
+	return that->_frame(false);
+}
 
-	for(auto it = tasks.begin(); it != tasks.end(); )
+bool Engine::_update()
+{
+	Replay::Step();
+	Profiler::EndFrame();
+
+	if(Counters::dumping())
+	{
+		auto lk = Audio::GetLock();
+		audioVoices.Set(Audio::voices().activeCount());
+	}
+
+	Counters::EndFrame();
+
+	return _frame(true);
+}
+
+bool Engine::_frame(bool draw)
+{
+	PROFILE_ZONE("Frame");
+
+	_frameEngine = this;
+
+	{
+		PROFILE_ZONE("Posted");
+		postedRun.Add((int64_t)_posted.Run(_postBudget));
+	}
 	{
-		if((*it)->Execute())
-			++it;
-		else
-			it = tasks.erase(it);
+		PROFILE_ZONE("Engine Tasks");
+
+		// tasks may add tasks, e.g. a coroutine calling SetState(), which
+		// would invalidate an iterator
+		for(size_t i = 0; i < tasks.size(); )
+		{
+			if(tasks[i]->Execute())
+				++i;
+			else
+				tasks.erase(tasks.begin() + i);
+		}
 	}
 
 	if(states.empty())
@@ -71,17 +130,39 @@ bool Engine::_update()
 
 	auto& topState = states.top();
 
-	topState->RunTasks_R();
-	topState->Update_R();
+	{
+		PROFILE_ZONE("RunTasks");
+		topState->registry.RunTasks();
+	}
+	{
+		PROFILE_ZONE("Update");
+		topState->registry.Update();
+	}
+
 	topState->physics->Update();
-	topState->LateUpdate_R();
-	topState->PreDrawUpdate_R();
+
+	{
+		PROFILE_ZONE("LateUpdate");
+		topState->registry.LateUpdate();
+	}
+	{
+		PROFILE_ZONE("PreDrawUpdate");
+		topState->registry.PreDrawUpdate();
+	}
 
 	if(quit) return false;
 
-	Graphics::Clear();
-	topState->StateDraw();
-	Graphics::Flip();
+	if(!draw) return true;
+
+	{
+		PROFILE_ZONE("Draw");
+		Graphics::Clear();
+		topState->StateDraw();
+	}
+	{
+		PROFILE_ZONE("Flip");
+		Graphics::Flip();
+	}
 	
 	return true;
 }
@@ -89,22 +170,39 @@ bool Engine::_update()
 void Engine::_setState(shared_ptr<State> state)
 {
 	while(!states.empty())
-		states.pop();
+		_removeTopState();
 
 	states.push(state);
+	state->registry.Attach(state.get());
 	state->Start();
 }
 
 void Engine::_pushState(shared_ptr<State> state)
 {
 	states.push(state);
+	state->registry.Attach(state.get());
 	state->Start();
 }
 
 void Engine::_popState()
 {
 	if(!states.empty())
-		states.pop();
+		_removeTopState();
+}
+
+void Engine::_removeTopState()
+{
+	shared_ptr<State> state = states.top();
+	states.pop();
+
+	// the level's arena goes with it, unless something else still holds
+	// the state. Anything left in the arena after that has leaked.
+	shared_ptr<Arena> arena = state->arena;
+	bool last = state.use_count() == 1;
+	state.reset();
+
+	if(arena && last)
+		arena->Release();
 }
 
 void Engine::SetState(shared_ptr<State> state)
@@ -129,54 +227,131 @@ void Engine::QuitGame()
 
 void Engine::RunAfterUpdate(const function<void()> &fx)
 {
+	if(!onMainThread())
+	{
+		Post(fx);
+		return;
+	}
+
 	that->tasks.emplace_back(new InvokeTask(fx));
 }
 
 void Engine::RunAfterDelay(const function<void()> &fx, float delay)
 {
+	if(!onMainThread())
+	{
+		Post([fx, delay]{ RunAfterDelay(fx, delay); });
+		return;
+	}
+
 	that->tasks.emplace_back(new DelayedTask(fx, Time::exactTime() + delay));
 }
 
 void Engine::RunCoroutine(const function<void(yield_token<float>)> &fx)
 {
+	if(!onMainThread())
+	{
+		Post([fx]{ RunCoroutine(fx); });
+		return;
+	}
+
 	unique_ptr<Task> task(new CoroutineTask(fx));
 
 	if(task->Execute())
 		that->tasks.emplace_back(move(task));
 }
 
+void Engine::Post(const function<void()> &fx)
+{
+	that->_posted.Post(fx);
+}
+
+void Engine::Post(vector<function<void()>> &&batch)
+{
+	that->_posted.Post(move(batch));
+}
+
+void Engine::SetPostBudget(float seconds)
+{
+	that->_postBudget = seconds;
+}
+
+float Engine::postBudget()
+{
+	return that->_postBudget;
+}
+
+bool Engine::onMainThread()
+{
+	return _frameEngine == (Engine*)that;
+}
+
+void Engine::_input(const InputEvent &event)
+{
+	// only recorded input reaches the game during a replay
+	if(Replay::replaying())
+		return;
+
+	Replay::Record(event);
+	_dispatch(event);
+}
+
+void Engine::_dispatch(const InputEvent &event)
+{
+	if(states.empty())
+		return;
+
+	auto state = states.top();
+
+	switch(event.type)
+	{
+	case InputEvent::Type::KeyDown:
+		state->OnKeyDown(event.key);
+		break;
+	case InputEvent::Type::KeyUp:
+		state->OnKeyUp(event.key);
+		break;
+	case InputEvent::Type::TouchDown:
+		state->OnTouchDown(event.x, event.y, event.id);
+		break;
+	case InputEvent::Type::TouchMove:
+		state->OnTouchMove(event.x, event.y, event.id);
+		break;
+	case InputEvent::Type::TouchUp:
+		state->OnTouchUp(event.x, event.y, event.id);
+		break;
+	case InputEvent::Type::Back:
+		state->OnBackPressed();
+		break;
+	}
+}
+
 void Engine::OnTouchDown(float x, float y, int id)
 {
-	if( !that->states.empty() )
-		that->states.top()->OnTouchDown(x, y, id);
+	that->_input(InputEvent(InputEvent::Type::TouchDown, x, y, id));
 }
 
 void Engine::OnTouchMove(float x, float y, int id)
 {
-	if( !that->states.empty() )
-		that->states.top()->OnTouchMove(x, y, id);
+	that->_input(InputEvent(InputEvent::Type::TouchMove, x, y, id));
 }
 
 void Engine::OnTouchUp(float x, float y, int id)
 {
-	if( !that->states.empty() )
-		that->states.top()->OnTouchUp(x, y, id);
+	that->_input(InputEvent(InputEvent::Type::TouchUp, x, y, id));
 }
 
 void Engine::OnKeyDown(KeyCode keyCode)
 {
-	if( !that->states.empty() )
-		that->states.top()->OnKeyDown(keyCode);
+	that->_input(InputEvent(InputEvent::Type::KeyDown, keyCode));
 }
 
 void Engine::OnKeyUp(KeyCode keyCode)
 {
-	if( !that->states.empty() )
-		that->states.top()->OnKeyUp(keyCode);
+	that->_input(InputEvent(InputEvent::Type::KeyUp, keyCode));
 }
 
 void Engine::OnBackPressed()
 {
-	if( !that->states.empty() )
-		that->states.top()->OnBackPressed();
+	that->_input(InputEvent(InputEvent::Type::Back));
 }
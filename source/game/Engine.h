@@ -8,9 +8,10 @@
 #include <stack>
 #include <memory>
 #include <vector>
-#include "Singleton.h"
+#include "EngineContext.h"
 #include "Keycodes.h"
 #include "Task.h"
+#include "DispatchQueue.h"
 
 using namespace std;
 
@@ -18,13 +19,23 @@ class State;
 class Camera;
 class Shader;
 class WindowsApp;
+struct InputEvent;
 
-class Engine : public Singleton<Engine>
+class Engine : public ContextSingleton<Engine>
 {
+	static thread_local Engine *_frameEngine;
+
+	DispatchQueue _posted;
+	float _postBudget;
+
 	void _setState(shared_ptr<State> state);
 	void _pushState(shared_ptr<State> state);
 	void _popState();
+	void _removeTopState();
 	bool _update();
+	bool _frame(bool draw);
+	void _input(const InputEvent &event);
+	void _dispatch(const InputEvent &event);
 
 	static bool Update();
 	static void OnTouchDown(float x, float y, int id);
@@ -44,16 +55,37 @@ public:
 	~Engine();
 
 	static void Initialize(WindowsApp *pApp);
+
+	// runs a frame without drawing, for states simulated in their own
+	// EngineContext on another thread. Returns false once the game quits.
+	static bool Simulate();
+
 	static void Terminate();
 	static void SetState(shared_ptr<State> state);
 	static void PushState(shared_ptr<State> state);
 	static void PopState();
 	
 	static void QuitGame();
+
+	// these may be called from any thread, from anywhere but the main thread
+	// they're posted and only start once the main thread takes them
 	static void RunAfterUpdate(const function<void()> &fx);
 	static void RunAfterDelay(const function<void()> &fx, float delay);
 	static void RunCoroutine(const function<void(yield_token<float>)> &fx);
 
+	// runs fx on the main thread at the start of a frame. Safe from any thread,
+	// a batch is posted at once and runs in order.
+	static void Post(const function<void()> &fx);
+	static void Post(vector<function<void()>> &&batch);
+
+	// seconds per frame spent running posted work, whatever doesn't fit runs
+	// next frame. 0 runs everything posted every frame.
+	static void SetPostBudget(float seconds);
+	static float postBudget();
+
+	// true on the thread running this context's frames
+	static bool onMainThread();
+
 	static shared_ptr<State> GetState() {
 		return that->states.top();
 	}
@@ -70,4 +102,6 @@ public:
 	friend class Sprite;
 	friend class PQGame;
 	friend class PQGameLoader;
+	friend class Replay;
+	friend class PQBenchmark;
 };
@@ -0,0 +1,66 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "EngineContext.h"
+#include <cassert>
+
+thread_local EngineContext *EngineContext::_current = nullptr;
+
+EngineContext::EngineContext()
+{
+	for(int i = 0; i < MaxSingletons; ++i)
+	{
+		_instances[i] = nullptr;
+		_deleters[i] = nullptr;
+	}
+}
+
+EngineContext::~EngineContext()
+{
+	Scope scope(this);
+
+	// reverse order of creation, like function statics
+	for(auto it = _created.rbegin(); it != _created.rend(); ++it)
+	{
+		_deleters[*it](_instances[*it].load(memory_order_relaxed));
+		_instances[*it] = nullptr;
+	}
+}
+
+EngineContext *EngineContext::defaultContext()
+{
+	static EngineContext context;
+	return &context;
+}
+
+int EngineContext::_allocateIndex()
+{
+	static atomic<int> next(0);
+
+	int index = next++;
+	assert(index < MaxSingletons);
+
+	return index;
+}
+
+void *EngineContext::_create(int index, void *(*create)(), void (*destroy)(void*))
+{
+	// recursive, constructors may use other context singletons
+	lock_guard<recursive_mutex> lk(_lock);
+
+	void *instance = _instances[index].load(memory_order_relaxed);
+
+	if(!instance)
+	{
+		Scope scope(this);
+
+		instance = create();
+		_deleters[index] = destroy;
+		_created.push_back(index);
+		_instances[index].store(instance, memory_order_release);
+	}
+
+	return instance;
+}
@@ -0,0 +1,111 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+class Camera;
+
+// Holds the instances of every ContextSingleton, so more than one game can
+// exist per process. Each thread works in the default context unless it binds
+// another with EngineContext::Scope, and ThreadPool jobs run in the context of
+// the thread that queued them.
+//
+// Engine, Time, RenderQueue, PlayerProfile and Random are per context.
+// Graphics, Audio and the other Singletons wrap process wide resources, like
+// the GL and AL contexts, and stay shared, as do the Counters. Only states
+// that don't touch GL or AL can be simulated in a context of their own;
+// PQGame can't, it uploads textures while it loads.
+class EngineContext
+{
+public:
+	static const int MaxSingletons = 64;
+
+	EngineContext();
+	~EngineContext();
+
+	EngineContext(const EngineContext&) = delete;
+	EngineContext &operator=(const EngineContext&) = delete;
+
+	static EngineContext *defaultContext();
+
+	static EngineContext *current() {
+		return _current ? _current : defaultContext();
+	}
+
+	// makes 'context' current on the calling thread until the scope ends
+	class Scope
+	{
+		EngineContext *_previous;
+	public:
+		Scope(EngineContext *context) : _previous(_current) { _current = context; }
+		~Scope() { _current = _previous; }
+
+		Scope(const Scope&) = delete;
+		Scope &operator=(const Scope&) = delete;
+	};
+
+	// this context's instance of T, created on first use
+	template<class T>
+	T &get()
+	{
+		static const int index = _allocateIndex();
+
+		void *instance = _instances[index].load(memory_order_acquire);
+
+		if(!instance)
+			instance = _create(index, &_new<T>, &_delete<T>);
+
+		return *(T*)instance;
+	}
+
+	weak_ptr<Camera> activeCamera;
+
+private:
+	static thread_local EngineContext *_current;
+
+	atomic<void*> _instances[MaxSingletons];
+	void (*_deleters[MaxSingletons])(void*);
+	vector<int> _created;
+	recursive_mutex _lock;
+
+	static int _allocateIndex();
+	void *_create(int index, void *(*create)(), void (*destroy)(void*));
+
+	template<class T> static void *_new() { return new T(); }
+	template<class T> static void _delete(void *p) { delete (T*)p; }
+};
+
+// same interface as Singleton, with one instance per EngineContext
+template<class T>
+class ContextSingleton
+{
+public:
+	virtual ~ContextSingleton(){}
+
+	static struct That
+	{
+		T& get() {
+			return EngineContext::current()->get<T>();
+		}
+
+		const T& get() const { return const_cast<That*>(this)->get(); }
+		inline T *operator->()				{ return  &get(); }
+		inline const T *operator->() const	{ return  &get(); }
+		inline operator T&()				{ return   get(); }
+		inline operator const T&() const	{ return   get(); }
+		inline operator T*()				{ return  &get(); }
+		inline operator const T*() const	{ return  &get(); }
+
+	} that;
+};
+
+template<class T>
+typename ContextSingleton<T>::That ContextSingleton<T>::that;
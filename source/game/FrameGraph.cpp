@@ -0,0 +1,80 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "FrameGraph.h"
+#include "Profiler.h"
+#include "Graphics.h"
+#include "Camera.h"
+
+struct GraphVertex
+{
+	vec2f position;
+	Color color;
+};
+
+FrameGraph::FrameGraph()
+{
+	_shader = make_shared<Shader>("assets\\Shaders\\color.vert", "assets\\Shaders\\color.frag");
+	aPositionID = _shader->GetAttribID("aPosition");
+	aColorID = _shader->GetAttribID("aColor");
+	uMtxMvpID = _shader->GetUniformID("uMtxMVP");
+}
+
+void FrameGraph::Draw(float pixelsPerMs)
+{
+	auto camera = Camera::activeCamera();
+	int frames = Profiler::frameCount();
+
+	if(!camera || frames == 0)
+		return;
+
+	const float limits[2] = { 1000.0f / 60.0f, 1000.0f / 30.0f };
+	const uint32_t count = (uint32_t)(frames + 2) * 2;
+
+	StreamRange range;
+	GraphVertex *verts = (GraphVertex*)Graphics::stream().Map(count * sizeof(GraphVertex), sizeof(GraphVertex), range);
+	if(!verts)
+		return;
+
+	const Rect &view = camera->viewRect;
+	float left = view.x + 8.0f;
+	float bottom = view.y + view.h - 8.0f;
+
+	GraphVertex *v = verts;
+
+	for(int i = 0; i < frames; ++i)
+	{
+		float ms = Profiler::frameTime(i);
+		float x = left + (float)(Profiler::HistorySize - 1 - i);
+
+		Color color = ms <= limits[0] ? Color(0.2f, 0.9f, 0.2f)
+					: ms <= limits[1] ? Color(1.0f, 0.8f, 0.1f)
+					: Color(1.0f, 0.2f, 0.2f);
+
+		v[0].position = vec2f(x, bottom);
+		v[1].position = vec2f(x, bottom - ms * pixelsPerMs);
+		v[0].color = v[1].color = color;
+		v += 2;
+	}
+
+	for(float limit : limits)
+	{
+		float y = bottom - limit * pixelsPerMs;
+
+		v[0].position = vec2f(left, y);
+		v[1].position = vec2f(left + (float)Profiler::HistorySize, y);
+		v[0].color = v[1].color = Color(1.0f, 1.0f, 1.0f, 0.5f);
+		v += 2;
+	}
+
+	Graphics::stream().Unmap();
+
+	_shader->SetActive();
+	_shader->SetUniform(uMtxMvpID, camera->matrix());
+	_shader->SetVertexBuffer(aPositionID, range.buffer, sizeof(GraphVertex), 0);
+	_shader->SetVertexBuffer(aColorID, range.buffer, sizeof(GraphVertex), sizeof(vec2f));
+
+	Graphics::DrawArray(range.offset / sizeof(GraphVertex), count, DrawMode::Lines);
+}
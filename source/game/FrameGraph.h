@@ -0,0 +1,25 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include "Shader.h"
+#include <memory>
+
+using namespace std;
+
+// Bar per frame of Profiler's frame history, newest on the right, in the
+// bottom left corner of the active camera. The guide lines are at 60 and 30 fps.
+class FrameGraph
+{
+	shared_ptr<Shader> _shader;
+	int aPositionID;
+	int aColorID;
+	int uMtxMvpID;
+
+public:
+	FrameGraph();
+
+	void Draw(float pixelsPerMs = 4.0f);
+};
@@ -4,6 +4,12 @@
 *--------------------------------------------------------------------------------------------*/
 
 #include "Graph.h"
+#include "Profiler.h"
+#include "Counters.h"
+#include "MathBatch.h"
+
+static Counter pathSearches("path.searches");
+static Counter pathNodesExpanded("path.nodes_expanded");
 
 void Graph::Node::AddNeighbour(Node *node)
 {
@@ -48,18 +54,15 @@ GraphNode *Graph::GetClosestNode(vec2f &pos)
 	if(nodes.empty())
 		return NULL;
 
+	distances.resize(positions.size());
+	math::Distances(pos, positions.data(), distances.data(), positions.size());
+
 	int idx = 0;
-	float dist = nodes[0]->pos.Distance(pos);
-	float tmp;
 
-	for(int i = 1; i < (int)nodes.size(); i++)
+	for(int i = 1; i < (int)distances.size(); i++)
 	{
-		tmp = nodes[i]->pos.Distance(pos);
-		if(tmp < dist)
-		{
-			dist = tmp;
+		if(distances[i] < distances[idx])
 			idx = i;
-		}
 	}
 
 	return nodes[idx];
@@ -68,6 +71,7 @@ GraphNode *Graph::GetClosestNode(vec2f &pos)
 void Graph::AddNode(float x, float y, bool isDestination)
 {
 	nodes.push_back(new Node(x, y, isDestination));
+	positions.push_back(vec2f(x, y));
 }
 
 void Graph::RemoveNode(int n)
@@ -76,6 +80,7 @@ void Graph::RemoveNode(int n)
 
 	delete nodes[n];
 	nodes.erase(nodes.begin() + n);
+	positions.erase(positions.begin() + n);
 }
 
 void Graph::Connect(int a, int b)
@@ -92,6 +97,9 @@ void Graph::Disconnect(int n)
 	
 bool Graph::FindPath(Node *start, Node *finish, deque<vec2f> &path)
 {
+	PROFILE_ZONE("Graph::FindPath");
+	pathSearches.Add();
+
 	open.clear();
 	closed.clear();
 	
@@ -118,6 +126,7 @@ bool Graph::FindPath(Node *start, Node *finish, deque<vec2f> &path)
 		
 		// get a pointer to the current node
 		Node *currentNode = currentRecord->node;
+		pathNodesExpanded.Add();
 
 		// if the current node is the finish point
 		if(currentNode == finish)
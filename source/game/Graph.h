@@ -49,6 +49,8 @@ public:
 	};
 
 	vector<Node*> nodes;
+	vector<vec2f> positions; // of 'nodes', for the batched distance search
+	vector<float> distances;
 	vector<NodeRecord> open;
 	vector<NodeRecord> closed;
 
@@ -6,6 +6,11 @@
 #include "Graphics.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "Counters.h"
+
+static Counter drawCalls("graphics.draw_calls");
+static Counter stateChanges("graphics.state_changes");
+static Counter stateChangesSkipped("graphics.state_changes_skipped");
 
 Graphics::Graphics()
 	: _viewPort(0, 0, 1, 1)
@@ -75,6 +80,9 @@ int Graphics::Initialize(HWND hWnd)
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+	that->_state.Reset();
+	that->_stream.Create();
 	
 	that->_defaultShader = make_shared<Shader>();
 	that->_defaultShader->Load("assets\\Shaders\\default.vert",
@@ -98,6 +106,8 @@ void Graphics::Destroy()
 	if(that->alive)
 	{
 		that->_defaultShader.reset();
+		that->_emptyTexture.reset();
+		that->_stream.Destroy();
 
 		if(that->hGLRC)
 		{
@@ -140,7 +150,12 @@ void Graphics::Clear()
 
 void Graphics::Flip()
 {
+	that->_stream.EndFrame();
 	SwapBuffers(that->hDC);
+	that->_state.EndFrame();
+
+	stateChanges.Add(that->_state.stats().totalIssued());
+	stateChangesSkipped.Add(that->_state.stats().totalSkipped());
 }
 
 string Graphics::GetError()
@@ -173,6 +188,14 @@ shared_ptr<Shader> Graphics::defaultShader()
 	return that->_defaultShader;
 }
 
+shared_ptr<Texture> Graphics::emptyTexture()
+{
+	if(!that->_emptyTexture)
+		that->_emptyTexture = make_shared<Texture>();
+
+	return that->_emptyTexture;
+}
+
 void Graphics::DrawArray(uint32_t start, uint32_t count, DrawMode mode)
 {
 	GLenum modes[] =
@@ -186,6 +209,7 @@ void Graphics::DrawArray(uint32_t start, uint32_t count, DrawMode mode)
 
 	auto f = glDrawArrays;
 	glDrawArrays(modes[(int)mode], start, count);
+	drawCalls.Add();
 }
 
 void Graphics::DrawIndexed(uint32_t start, uint32_t count, DrawMode mode)
@@ -200,4 +224,20 @@ void Graphics::DrawIndexed(uint32_t start, uint32_t count, DrawMode mode)
 	};
 
 	glDrawElements(modes[(int)mode], count, GL_UNSIGNED_INT, nullptr);
+	drawCalls.Add();
+}
+
+RenderState &Graphics::state()
+{
+	return that->_state;
+}
+
+StreamingBuffer &Graphics::stream()
+{
+	return that->_stream;
+}
+
+const RenderStats &Graphics::renderStats()
+{
+	return that->_state.stats();
 }
@@ -10,6 +10,8 @@
 #include "Shader.h"
 #include "DrawBuffer.h"
 #include "RenderQueue.h"
+#include "RenderState.h"
+#include "StreamingBuffer.h"
 
 enum class DrawMode
 {
@@ -35,9 +37,15 @@ public:
 	static int height();
 	static Rect viewport();
 	static shared_ptr<Shader> defaultShader();
+
+	// placeholder for sprites without a texture, released by Destroy()
+	static shared_ptr<Texture> emptyTexture();
 	static string GetError();
 	static void DrawArray(uint32_t start, uint32_t count, DrawMode mode);
 	static void DrawIndexed(uint32_t start, uint32_t count, DrawMode mode);
+	static RenderState &state();
+	static StreamingBuffer &stream();
+	static const RenderStats &renderStats();
 private:
 	Rect _viewPort;
 	bool alive;
@@ -47,4 +55,7 @@ private:
 	int _width;
 	int _height;
 	shared_ptr<Shader> _defaultShader;
+	shared_ptr<Texture> _emptyTexture;
+	RenderState _state;
+	StreamingBuffer _stream;
 };
@@ -0,0 +1,441 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "Log.h"
+#include "Time.h"
+#include <Windows.h>
+#include <algorithm>
+#include <sstream>
+#include <chrono>
+#include <cstring>
+
+static const char *LevelNames[] = { "debug", "info", "warning", "error" };
+static const char *CategoryNames[] = { "general", "graphics", "audio", "physics", "resources", "game" };
+
+void Log(LogLevel level, LogCategory category, const char *message)
+{
+	Logger::Write(level, category, message, Logger::ArgType::None, nullptr, nullptr);
+}
+
+void Log(LogLevel level, LogCategory category, const char *message, const char *arg)
+{
+	Logger::Write(level, category, message, Logger::ArgType::String, nullptr, arg);
+}
+
+void Log(LogLevel level, LogCategory category, const char *message, const string &arg)
+{
+	Logger::Write(level, category, message, Logger::ArgType::String, nullptr, arg.c_str());
+}
+
+void Log(LogLevel level, LogCategory category, const char *message, int arg)
+{
+	Logger::Write(level, category, message, Logger::ArgType::Int, &arg, nullptr);
+}
+
+void Log(LogLevel level, LogCategory category, const char *message, unsigned int arg)
+{
+	Logger::Write(level, category, message, Logger::ArgType::Unsigned, &arg, nullptr);
+}
+
+void Log(LogLevel level, LogCategory category, const char *message, float arg)
+{
+	Logger::Write(level, category, message, Logger::ArgType::Float, &arg, nullptr);
+}
+
+////////////////////////
+
+thread_local Logger::RingLease Logger::_lease;
+
+Logger::RingLease::RingLease()
+	: ring(nullptr), threadID(0)
+{
+	for(int i = 0; i < (int)LogCategory::Count; ++i)
+	{
+		window[i] = 0;
+		windowCount[i] = 0;
+	}
+}
+
+Logger::RingLease::~RingLease()
+{
+	if(ring)
+	{
+		lock_guard<mutex> lk(that->_lock);
+		that->_freeRings.push_back(ring);
+	}
+}
+
+Logger::Logger()
+{
+	for(auto &level : _levels)
+		level = (uint8_t)LogLevel::Info;
+
+	_rateLimit = 50;
+	_frequency = Time::frequency();
+	_start = Time::ticks();
+	_file = nullptr;
+	_stderr = false;
+	_debugger = true;
+	_running = false;
+}
+
+Logger::~Logger()
+{
+	Shutdown();
+	CloseFile();
+}
+
+void Logger::SetLevel(LogLevel level)
+{
+	for(auto &lvl : that->_levels)
+		lvl = (uint8_t)level;
+}
+
+void Logger::SetLevel(LogCategory category, LogLevel level)
+{
+	that->_levels[(int)category] = (uint8_t)level;
+}
+
+void Logger::SetRateLimit(int recordsPerSecond)
+{
+	that->_rateLimit = recordsPerSecond;
+}
+
+int Logger::rateLimit()
+{
+	return that->_rateLimit;
+}
+
+bool Logger::OpenFile(const string &filename)
+{
+	FILE *file = nullptr;
+
+	if(fopen_s(&file, filename.c_str(), "w") != 0 || !file)
+	{
+		Log(LogLevel::Error, LogCategory::General, "Couldn't open log file", filename);
+		return false;
+	}
+
+	lock_guard<mutex> lk(that->_drainLock);
+
+	if(that->_file)
+		fclose(that->_file);
+
+	that->_file = file;
+
+	return true;
+}
+
+void Logger::CloseFile()
+{
+	Flush();
+
+	lock_guard<mutex> lk(that->_drainLock);
+
+	if(that->_file)
+	{
+		fclose(that->_file);
+		that->_file = nullptr;
+	}
+}
+
+void Logger::WriteToStderr(bool enable)
+{
+	lock_guard<mutex> lk(that->_drainLock);
+	that->_stderr = enable;
+}
+
+void Logger::WriteToDebugger(bool enable)
+{
+	lock_guard<mutex> lk(that->_drainLock);
+	that->_debugger = enable;
+}
+
+void Logger::Flush()
+{
+	that->_drain();
+}
+
+void Logger::_startWriter()
+{
+	lock_guard<mutex> lk(_lock);
+
+	if(_running)
+		return;
+
+	_running = true;
+	_writer = thread(&Logger::_writerLoop, this);
+}
+
+void Logger::Shutdown()
+{
+	thread writer;
+
+	{
+		lock_guard<mutex> lk(that->_lock);
+
+		if(that->_running)
+		{
+			lock_guard<mutex> wakeLock(that->_wakeLock);
+			that->_running = false;
+			that->_wake.notify_one();
+		}
+
+		writer = move(that->_writer);
+	}
+
+	if(writer.joinable())
+		writer.join();
+
+	that->_drain();
+}
+
+void Logger::Configure(const string &commandLine)
+{
+	istringstream args(commandLine);
+	string arg;
+
+	while(args >> arg)
+	{
+		if(arg == "-log")
+		{
+			string filename;
+			if(args >> filename)
+				OpenFile(filename);
+		}
+		else if(arg == "-log-stderr")
+		{
+			WriteToStderr(true);
+		}
+		else if(arg == "-log-level")
+		{
+			string name;
+			args >> name;
+
+			for(int i = 0; i < (int)LogLevel::Count; ++i)
+			{
+				if(name == LevelNames[i])
+					SetLevel((LogLevel)i);
+			}
+		}
+		else if(arg == "-log-rate")
+		{
+			int rate;
+			if(args >> rate)
+				SetRateLimit(rate);
+		}
+	}
+}
+
+Logger::Ring *Logger::_acquireRing()
+{
+	lock_guard<mutex> lk(_lock);
+
+	if(!_freeRings.empty())
+	{
+		Ring *ring = _freeRings.back();
+		_freeRings.pop_back();
+		return ring;
+	}
+
+	_rings.emplace_back(new Ring());
+
+	Ring *ring = _rings.back().get();
+	ring->head = 0;
+	ring->tail = 0;
+	ring->dropped = 0;
+	ring->suppressed = 0;
+
+	return ring;
+}
+
+void Logger::Write(LogLevel level, LogCategory category, const char *message,
+				   ArgType argType, const void *arg, const char *str)
+{
+	if(!enabled(level, category))
+		return;
+
+	if(!that->_running.load(memory_order_relaxed))
+		that->_startWriter();
+
+	RingLease &lease = _lease;
+
+	if(!lease.ring)
+	{
+		lease.ring = that->_acquireRing();
+		lease.threadID = GetCurrentThreadId();
+	}
+
+	Ring *ring = lease.ring;
+	long long now = Time::ticks();
+	int c = (int)category;
+	int limit = that->_rateLimit.load(memory_order_relaxed);
+
+	if(limit > 0)
+	{
+		if(now - lease.window[c] >= that->_frequency)
+		{
+			lease.window[c] = now;
+			lease.windowCount[c] = 0;
+		}
+
+		if(++lease.windowCount[c] > (uint32_t)limit)
+		{
+			ring->suppressed.fetch_add(1, memory_order_relaxed);
+			return;
+		}
+	}
+	uint32_t head = ring->head.load(memory_order_relaxed);
+
+	if(head - ring->tail.load(memory_order_acquire) >= RingSize)
+	{
+		ring->dropped.fetch_add(1, memory_order_relaxed);
+		return;
+	}
+
+	Record &record = ring->records[head & (RingSize - 1)];
+	record.ticks = now;
+	record.threadID = lease.threadID;
+	record.level = level;
+	record.category = category;
+	record.argType = argType;
+
+	switch(argType)
+	{
+	case ArgType::Int:      record.arg.i = *(const int*)arg; break;
+	case ArgType::Unsigned: record.arg.u = *(const unsigned int*)arg; break;
+	case ArgType::Float:    record.arg.f = *(const float*)arg; break;
+	default: break;
+	}
+
+	// message and string argument share the text, both are cut short to fit
+	size_t length = strnlen(message, TextSize - 2);
+	memcpy(record.text, message, length);
+	record.text[length] = 0;
+
+	if(argType == ArgType::String)
+	{
+		char *dst = record.text + length + 1;
+		size_t room = TextSize - length - 2;
+		size_t strLength = str ? strnlen(str, room) : 0;
+
+		memcpy(dst, str, strLength);
+		dst[strLength] = 0;
+	}
+
+	ring->head.store(head + 1, memory_order_release);
+
+	if(level >= LogLevel::Error)
+		that->_wake.notify_one();
+}
+
+void Logger::_writerLoop()
+{
+	unique_lock<mutex> lk(_wakeLock);
+
+	while(_running)
+	{
+		_wake.wait_for(lk, chrono::milliseconds(10));
+
+		lk.unlock();
+		_drain();
+		lk.lock();
+	}
+}
+
+void Logger::_drain()
+{
+	vector<Ring*> rings;
+
+	{
+		lock_guard<mutex> lk(_lock);
+
+		for(auto &ring : _rings)
+			rings.push_back(ring.get());
+	}
+
+	lock_guard<mutex> lk(_drainLock);
+
+	vector<Record> pending;
+	uint32_t dropped = 0;
+	uint32_t suppressed = 0;
+
+	for(Ring *ring : rings)
+	{
+		dropped += ring->dropped.exchange(0, memory_order_relaxed);
+		suppressed += ring->suppressed.exchange(0, memory_order_relaxed);
+
+		uint32_t tail = ring->tail.load(memory_order_relaxed);
+		uint32_t head = ring->head.load(memory_order_acquire);
+
+		for( ; tail != head; ++tail)
+			pending.push_back(ring->records[tail & (RingSize - 1)]);
+
+		ring->tail.store(tail, memory_order_release);
+	}
+
+	// each ring is in order, merge them by time
+	stable_sort(pending.begin(), pending.end(),
+		[](const Record &a, const Record &b){ return a.ticks < b.ticks; });
+
+	for(auto &record : pending)
+		_emit(record);
+
+	char line[64];
+
+	if(dropped)
+	{
+		snprintf(line, sizeof(line), "%u log records dropped, a ring was full\n", dropped);
+		_output(line);
+	}
+
+	if(suppressed)
+	{
+		snprintf(line, sizeof(line), "%u log records over the rate limit\n", suppressed);
+		_output(line);
+	}
+
+	if(_file && !pending.empty())
+		fflush(_file);
+}
+
+void Logger::_emit(const Record &record)
+{
+	char message[TextSize + 64];
+	const char *text = record.text;
+
+	switch(record.argType)
+	{
+	case ArgType::String:   snprintf(message, sizeof(message), "%s: %s", text, text + strlen(text) + 1); break;
+	case ArgType::Int:      snprintf(message, sizeof(message), "%s: %i", text, record.arg.i); break;
+	case ArgType::Unsigned: snprintf(message, sizeof(message), "%s: %u", text, record.arg.u); break;
+	case ArgType::Float:    snprintf(message, sizeof(message), "%s: %f", text, record.arg.f); break;
+	default:                snprintf(message, sizeof(message), "%s", text); break;
+	}
+
+	char line[TextSize + 128];
+	snprintf(line, sizeof(line), "%10.3f %-7s %-9s %s\n",
+			 (double)(record.ticks - _start) / (double)_frequency,
+			 LevelNames[(int)record.level],
+			 CategoryNames[(int)record.category],
+			 message);
+
+	_output(line);
+}
+
+void Logger::_output(const char *line)
+{
+	if(_debugger)
+	{
+		OutputDebugStringA("Engine: ");
+		OutputDebugStringA(line);
+	}
+
+	if(_stderr)
+		fputs(line, stderr);
+
+	if(_file)
+		fputs(line, _file);
+}
@@ -0,0 +1,167 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include "Singleton.h"
+
+using namespace std;
+
+enum class LogLevel : uint8_t
+{
+	Debug,
+	Info,
+	Warning,
+	Error,
+	Count
+};
+
+enum class LogCategory : uint8_t
+{
+	General,
+	Graphics,
+	Audio,
+	Physics,
+	Resources,
+	Game,
+	Count
+};
+
+// Log(level, category, message[, arg]) copies the message and its argument
+// into a fixed size record in the calling thread's ring and returns. Nothing
+// is formatted or written on the calling thread, and a full ring drops the
+// record instead of waiting. A background thread formats the records and
+// writes them to the debugger, and optionally a file and stderr.
+//
+// Each thread may log up to rateLimit() records per second in a category,
+// the rest are only counted, like the records dropped by a full ring.
+void Log(LogLevel level, LogCategory category, const char *message);
+void Log(LogLevel level, LogCategory category, const char *message, const char *arg);
+void Log(LogLevel level, LogCategory category, const char *message, const string &arg);
+void Log(LogLevel level, LogCategory category, const char *message, int arg);
+void Log(LogLevel level, LogCategory category, const char *message, unsigned int arg);
+void Log(LogLevel level, LogCategory category, const char *message, float arg);
+
+class Logger : public Singleton<Logger>
+{
+public:
+	static const uint32_t RingSize = 256;   // records per thread, power of two
+	static const size_t TextSize = 216;     // message and string argument
+
+	enum class ArgType : uint8_t
+	{
+		None,
+		String,
+		Int,
+		Unsigned,
+		Float
+	};
+
+	struct Record
+	{
+		long long ticks;
+		uint32_t threadID;
+		LogLevel level;
+		LogCategory category;
+		ArgType argType;
+		union
+		{
+			int i;
+			unsigned int u;
+			float f;
+		} arg;
+		char text[TextSize]; // the message, then the string argument if any
+	};
+
+	Logger();
+	~Logger();
+
+	// records below 'level' are dropped before they're copied
+	static void SetLevel(LogLevel level);
+	static void SetLevel(LogCategory category, LogLevel level);
+	static bool enabled(LogLevel level, LogCategory category) {
+		return (uint8_t)level >= that->_levels[(int)category].load(memory_order_relaxed);
+	}
+
+	static void SetRateLimit(int recordsPerSecond);
+	static int rateLimit();
+
+	static bool OpenFile(const string &filename);
+	static void CloseFile();
+	static void WriteToStderr(bool enable);
+	static void WriteToDebugger(bool enable);
+
+	// returns once every record logged before the call has been written
+	static void Flush();
+
+	// stops the writer thread after flushing, logging afterwards starts it again
+	static void Shutdown();
+
+	// handles "-log <file>", "-log-stderr", "-log-level <debug|info|warning|error>"
+	// and "-log-rate <records per second>" anywhere on the command line
+	static void Configure(const string &commandLine);
+
+	static void Write(LogLevel level, LogCategory category, const char *message,
+					  ArgType argType, const void *arg, const char *str);
+
+private:
+	struct Ring
+	{
+		atomic<uint32_t> head;
+		atomic<uint32_t> tail;
+		atomic<uint32_t> dropped;
+		atomic<uint32_t> suppressed;
+		Record records[RingSize];
+	};
+
+	// gives the ring back when its thread exits, records still in it are
+	// written as usual
+	struct RingLease
+	{
+		Ring *ring;
+		uint32_t threadID;
+		long long window[(int)LogCategory::Count];
+		uint32_t windowCount[(int)LogCategory::Count];
+
+		RingLease();
+		~RingLease();
+	};
+
+	static thread_local RingLease _lease;
+
+	atomic<uint8_t> _levels[(int)LogCategory::Count];
+	atomic<int> _rateLimit;
+	long long _frequency;
+	long long _start;
+
+	mutex _lock;
+	vector<unique_ptr<Ring>> _rings;
+	vector<Ring*> _freeRings;
+
+	mutex _drainLock;
+	FILE *_file;
+	bool _stderr;
+	bool _debugger;
+
+	thread _writer;
+	mutex _wakeLock;
+	condition_variable _wake;
+	atomic<bool> _running;
+
+	Ring *_acquireRing();
+	void _startWriter();
+	void _writerLoop();
+	void _drain();
+	void _emit(const Record &record);
+	void _output(const char *line);
+};
@@ -5,11 +5,31 @@
 
 #include "MP3Decoder.h"
 #include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <climits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define MP3_SSE2
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON)
+  #define MP3_NEON
+  #include <arm_neon.h>
+#endif
+
 using namespace std;
 
 MP3Decoder::MP3Decoder()
 {
 	mad_synth_init(&synth);
+
+	_samplesPerFrame = 0;
+	_sampleRate = 0;
+	_channels = 0;
+	_begin = 0;
+	_end = 0;
+	_position = 0;
+	_skipUntil = 0;
 }
 
 MP3Decoder::~MP3Decoder()
@@ -49,7 +69,16 @@ int MP3Decoder::Open(const char *filename)
 		return 0;
 	}
 
+	if(!_buildIndex())
+	{
+		fin.close();
+		fin.clear();
+		cout << "MP3Decoder no audio frames in file:" << filename << endl;
+		return 0;
+	}
+
 	_initMAD();
+	Seek(0);
 
 	return 1;
 }
@@ -62,23 +91,239 @@ void MP3Decoder::Close()
 		fin.clear();
 		_finishMAD();
 	}
+
+	_frames.clear();
 }
 
 void MP3Decoder::Rewind()
 {
-	if(fin.is_open())
+	Seek(0);
+}
+
+bool MP3Decoder::Seek(uint64_t sample)
+{
+	if(!fin.is_open() || _frames.empty())
+		return false;
+
+	uint64_t target = min(_begin + sample, _end);
+	uint64_t index = target / _samplesPerFrame;
+	uint64_t start = index > SeekPreroll ? index - SeekPreroll : 0;
+
+	if(start >= _frames.size())
+		start = _frames.size() - 1;
+
+	fin.clear();
+	fin.seekg(_frames[(size_t)start]);
+
+	_finishMAD();
+	_initMAD();
+
+	_position = start * _samplesPerFrame;
+	_skipUntil = max(target, _begin);
+
+	return true;
+}
+
+uint64_t MP3Decoder::length() const
+{
+	return _end - _begin;
+}
+
+uint64_t MP3Decoder::position() const
+{
+	return max(_position, _skipUntil) - _begin;
+}
+
+static uint32_t readBE32(const unsigned char *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+bool MP3Decoder::_parseHeader(const unsigned char *h, FrameHeader &header)
+{
+	static const int bitrates[2][15] = {
+		{ 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 },     // MPEG 2 and 2.5
+		{ 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 }, // MPEG 1
+	};
+
+	static const unsigned int sampleRates[4][3] = {
+		{ 11025, 12000, 8000 },  // MPEG 2.5
+		{ 0, 0, 0 },             // reserved
+		{ 22050, 24000, 16000 }, // MPEG 2
+		{ 44100, 48000, 32000 }, // MPEG 1
+	};
+
+	if(h[0] != 0xFF || (h[1] & 0xE0) != 0xE0)
+		return false;
+
+	int version = (h[1] >> 3) & 3;
+	int layer = (h[1] >> 1) & 3;
+	int bitrateIndex = h[2] >> 4;
+	int rateIndex = (h[2] >> 2) & 3;
+
+	// layer III only
+	if(version == 1 || layer != 1 || bitrateIndex == 0 || bitrateIndex == 15 || rateIndex == 3)
+		return false;
+
+	header.mpeg1 = version == 3;
+	header.bitrate = bitrates[header.mpeg1 ? 1 : 0][bitrateIndex] * 1000;
+	header.sampleRate = sampleRates[version][rateIndex];
+	header.channels = (h[3] >> 6) == 3 ? 1 : 2;
+	header.samplesPerFrame = header.mpeg1 ? 1152 : 576;
+	header.length = (header.samplesPerFrame / 8) * header.bitrate / header.sampleRate + ((h[2] >> 1) & 1);
+
+	return true;
+}
+
+bool MP3Decoder::_readAt(uint64_t offset, unsigned char *dst, size_t size)
+{
+	fin.clear();
+	fin.seekg(offset);
+	fin.read((char*)dst, size);
+	return (size_t)fin.gcount() == size;
+}
+
+bool MP3Decoder::_buildIndex()
+{
+	_frames.clear();
+	_begin = 0;
+	_end = 0;
+
+	fin.clear();
+	fin.seekg(0, ios_base::end);
+	uint64_t fileSize = (uint64_t)fin.tellg();
+
+	// headers are read through a window so the scan doesn't seek per frame
+	vector<unsigned char> window(64 * 1024);
+	uint64_t windowStart = 0;
+	size_t windowSize = 0;
+
+	auto peek = [&](uint64_t offset, size_t size) -> const unsigned char*
 	{
-		fin.clear();
-		fin.seekg(0);
+		if(offset < windowStart || offset + size > windowStart + windowSize)
+		{
+			windowStart = offset;
+			windowSize = (size_t)min((uint64_t)window.size(), fileSize - offset);
 
-		_finishMAD();
-		_initMAD();
+			if(!_readAt(offset, window.data(), windowSize))
+				windowSize = 0;
+		}
+
+		return offset + size <= windowStart + windowSize ? &window[(size_t)(offset - windowStart)] : nullptr;
+	};
+
+	uint64_t pos = 0;
+	const unsigned char *h;
+
+	// skip an ID3v2 tag
+	if((h = peek(0, 10)) && h[0] == 'I' && h[1] == 'D' && h[2] == '3')
+	{
+		uint32_t size = ((h[6] & 0x7F) << 21) | ((h[7] & 0x7F) << 14) | ((h[8] & 0x7F) << 7) | (h[9] & 0x7F);
+		pos = 10 + size + ((h[5] & 0x10) ? 10 : 0);
+	}
+
+	FrameHeader first;
+	bool found = false;
+
+	// find the first frame
+	while((h = peek(pos, 4)) != nullptr)
+	{
+		if(_parseHeader(h, first))
+		{
+			found = true;
+			break;
+		}
+
+		++pos;
+	}
+
+	if(!found)
+		return false;
+
+	_samplesPerFrame = first.samplesPerFrame;
+	_sampleRate = first.sampleRate;
+	_channels = first.channels;
+
+	int encoderDelay = -1;
+	int encoderPadding = 0;
+
+	// a Xing/Info frame holds metadata instead of audio
+	{
+		unsigned char data[2048] = {};
+		size_t size = (size_t)min((uint64_t)min((size_t)first.length, sizeof(data)), fileSize - pos);
+		_readAt(pos, data, size);
+
+		size_t xing = 4 + (first.mpeg1 ? (first.channels == 1 ? 17 : 32) : (first.channels == 1 ? 9 : 17));
+
+		if(xing + 8 <= size && (!memcmp(data + xing, "Xing", 4) || !memcmp(data + xing, "Info", 4)))
+		{
+			uint32_t flags = readBE32(data + xing + 4);
+			size_t p = xing + 8;
+
+			if(flags & 1) p += 4;   // frame count
+			if(flags & 2) p += 4;   // byte count
+			if(flags & 4) p += 100; // seek table
+			if(flags & 8) p += 4;   // quality
+
+			// LAME tag: 9 byte version, then 12 bits of delay and 12 of padding at +21
+			if(p + 24 <= size && (!memcmp(data + p, "LAME", 4) || !memcmp(data + p, "Lavc", 4) || !memcmp(data + p, "Lavf", 4)))
+			{
+				const unsigned char *dp = data + p + 21;
+				encoderDelay = (dp[0] << 4) | (dp[1] >> 4);
+				encoderPadding = ((dp[1] & 0x0F) << 8) | dp[2];
+			}
+
+			pos += first.length;
+		}
+	}
+
+	// index the audio frames
+	FrameHeader header;
+
+	while((h = peek(pos, 4)) != nullptr)
+	{
+		if(_parseHeader(h, header) && header.sampleRate == _sampleRate)
+		{
+			_frames.push_back((uint32_t)pos);
+			pos += header.length;
+		}
+		else if(h[0] == 'T' && h[1] == 'A' && h[2] == 'G')
+		{
+			break; // ID3v1 tag
+		}
+		else
+		{
+			++pos; // resync
+		}
 	}
+
+	fin.clear();
+
+	if(_frames.empty())
+		return false;
+
+	uint64_t total = (uint64_t)_frames.size() * _samplesPerFrame;
+
+	if(encoderDelay >= 0)
+	{
+		uint64_t trimmed = (uint64_t)(encoderDelay + encoderPadding);
+		uint64_t valid = total > trimmed ? total - trimmed : 0;
+
+		_begin = min((uint64_t)(encoderDelay + DecoderDelay), total);
+		_end = min(_begin + valid, total);
+	}
+	else
+	{
+		_begin = 0;
+		_end = total;
+	}
+
+	return true;
 }
 
 unsigned int MP3Decoder::SampleRate()
 {
-	return synth.pcm.samplerate;
+	return synth.pcm.samplerate ? synth.pcm.samplerate : _sampleRate;
 }
 
 unsigned short MP3Decoder::SamplesPerChannel()
@@ -88,23 +333,160 @@ unsigned short MP3Decoder::SamplesPerChannel()
 
 unsigned short MP3Decoder::Channels()
 {
-	return synth.pcm.channels;
+	return synth.pcm.channels ? synth.pcm.channels : _channels;
 }
 
 int MP3Decoder::GetSamples(short *sampleBuffer, int maxSamples)
+{
+	return _decode(sampleBuffer, maxSamples);
+}
+
+int MP3Decoder::GetSamples(float *sampleBuffer, int maxSamples)
+{
+	return _decode(sampleBuffer, maxSamples);
+}
+
+// (x >> 13) saturated to 16 bits gives the same result as _fixedToShort
+void MP3Decoder::_convert(const mad_fixed_t *left, const mad_fixed_t *right, short *out, int count)
+{
+	const int shift = MAD_F_FRACBITS - 15;
+	int i = 0;
+
+#if defined(MP3_SSE2)
+	if(right)
+	{
+		for( ; i + 8 <= count; i += 8)
+		{
+			__m128i l0 = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)(left + i)), shift);
+			__m128i l1 = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)(left + i + 4)), shift);
+			__m128i r0 = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)(right + i)), shift);
+			__m128i r1 = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)(right + i + 4)), shift);
+			__m128i l = _mm_packs_epi32(l0, l1);
+			__m128i r = _mm_packs_epi32(r0, r1);
+			_mm_storeu_si128((__m128i*)(out + i * 2), _mm_unpacklo_epi16(l, r));
+			_mm_storeu_si128((__m128i*)(out + i * 2 + 8), _mm_unpackhi_epi16(l, r));
+		}
+	}
+	else
+	{
+		for( ; i + 8 <= count; i += 8)
+		{
+			__m128i l0 = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)(left + i)), shift);
+			__m128i l1 = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)(left + i + 4)), shift);
+			_mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(l0, l1));
+		}
+	}
+#elif defined(MP3_NEON)
+	if(right)
+	{
+		for( ; i + 4 <= count; i += 4)
+		{
+			int16x4x2_t lr;
+			lr.val[0] = vqshrn_n_s32(vld1q_s32(left + i), MAD_F_FRACBITS - 15);
+			lr.val[1] = vqshrn_n_s32(vld1q_s32(right + i), MAD_F_FRACBITS - 15);
+			vst2_s16(out + i * 2, lr);
+		}
+	}
+	else
+	{
+		for( ; i + 4 <= count; i += 4)
+			vst1_s16(out + i, vqshrn_n_s32(vld1q_s32(left + i), MAD_F_FRACBITS - 15));
+	}
+#endif
+
+	if(right)
+	{
+		for( ; i < count; ++i)
+		{
+			out[i * 2] = _fixedToShort(left[i]);
+			out[i * 2 + 1] = _fixedToShort(right[i]);
+		}
+	}
+	else
+	{
+		for( ; i < count; ++i)
+			out[i] = _fixedToShort(left[i]);
+	}
+}
+
+void MP3Decoder::_convert(const mad_fixed_t *left, const mad_fixed_t *right, float *out, int count)
+{
+	const float scale = 1.0f / (float)MAD_F_ONE;
+	int i = 0;
+
+#if defined(MP3_SSE2)
+	const __m128 vscale = _mm_set1_ps(scale);
+
+	if(right)
+	{
+		for( ; i + 4 <= count; i += 4)
+		{
+			__m128 l = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(left + i))), vscale);
+			__m128 r = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(right + i))), vscale);
+			_mm_storeu_ps(out + i * 2, _mm_unpacklo_ps(l, r));
+			_mm_storeu_ps(out + i * 2 + 4, _mm_unpackhi_ps(l, r));
+		}
+	}
+	else
+	{
+		for( ; i + 4 <= count; i += 4)
+			_mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(left + i))), vscale));
+	}
+#endif
+
+	if(right)
+	{
+		for( ; i < count; ++i)
+		{
+			out[i * 2] = (float)left[i] * scale;
+			out[i * 2 + 1] = (float)right[i] * scale;
+		}
+	}
+	else
+	{
+		for( ; i < count; ++i)
+			out[i] = (float)left[i] * scale;
+	}
+}
+
+template<class T>
+int MP3Decoder::_decode(T *sampleBuffer, int maxSamples)
 {
 	int nSamples = 0;
 
 	while(nSamples < maxSamples)
 	{
-		if(synthSampleOffset < synthSampleCount) // output all PCM samples
+		if(_position >= _end)
 		{
-			sampleBuffer[nSamples++] = _fixedToShort( synth.pcm.samples[MAD_LEFT_CHAN][synthSampleOffset] );
+			break;
+		}
+		else if(synthSampleOffset < synthSampleCount) // output all PCM samples
+		{
+			int available = synthSampleCount - synthSampleOffset;
+
+			if(_position < _skipUntil)
+			{
+				int skip = (int)min((uint64_t)available, _skipUntil - _position);
+				synthSampleOffset += skip;
+				_position += skip;
+				continue;
+			}
 
-			if(MAD_NCHANNELS(&frame.header) == 2)
-				sampleBuffer[nSamples++] = _fixedToShort( synth.pcm.samples[MAD_RIGHT_CHAN][synthSampleOffset] );
+			int channels = MAD_NCHANNELS(&frame.header);
+			int count = min(available, (maxSamples - nSamples) / channels);
+			count = (int)min((uint64_t)count, _end - _position);
 
-			++synthSampleOffset;
+			if(count <= 0)
+				break;
+
+			const mad_fixed_t *left = &synth.pcm.samples[MAD_LEFT_CHAN][synthSampleOffset];
+			const mad_fixed_t *right = channels == 2 ? &synth.pcm.samples[MAD_RIGHT_CHAN][synthSampleOffset] : nullptr;
+
+			_convert(left, right, sampleBuffer + nSamples, count);
+
+			nSamples += count * channels;
+			synthSampleOffset += count;
+			_position += count;
 		}
 		else
 		{
@@ -166,6 +548,11 @@ int MP3Decoder::GetSamples(short *sampleBuffer, int maxSamples)
 			{
 				if(MAD_RECOVERABLE(stream.error) || stream.error == MAD_ERROR_BUFLEN)
 				{
+					// a frame whose reservoir data was skipped by a seek still
+					// takes up its place in the timeline
+					if(stream.error == MAD_ERROR_BADDATAPTR)
+						_position += _samplesPerFrame;
+
 					continue;
 				}
 				else
@@ -7,7 +7,9 @@
 
 #include <mad.h>
 #include <fstream>
+#include <vector>
 #include <cassert>
+#include <cstdint>
 
 using namespace std;
 
@@ -16,6 +18,11 @@ using namespace std;
 #define MAD_LEFT_CHAN 0
 #define MAD_RIGHT_CHAN 1
 
+// Layer III decoder over libmad. Open() scans the frame headers once to build
+// an index of frame offsets, which makes Seek() a jump to a known frame plus a
+// short preroll. When the file has a Xing/LAME tag, the encoder delay and
+// padding are trimmed so decoded output is sample accurate and loops without
+// gaps. Sample positions count samples per channel.
 class MP3Decoder
 {
 public:
@@ -26,18 +33,48 @@ public:
 	void Close();
 
 	void Rewind();
+	bool Seek(uint64_t sample);
 
+	// interleaved samples, maxSamples counts values across all channels
 	int GetSamples(short *sampleBuffer, int maxSamples);
+	int GetSamples(float *sampleBuffer, int maxSamples);
 
 	unsigned int SampleRate();
 	unsigned short SamplesPerChannel();
 	unsigned short Channels();
 
+	// length of the trimmed stream and the next sample GetSamples will output
+	uint64_t length() const;
+	uint64_t position() const;
+
 private:
 	
+	struct FrameHeader
+	{
+		bool mpeg1;
+		int bitrate;
+		unsigned int sampleRate;
+		unsigned short channels;
+		int samplesPerFrame;
+		int length;
+	};
+
+	// frames decoded ahead of a seek target to refill the bit reservoir and
+	// the synthesis overlap
+	static const int SeekPreroll = 3;
+
+	// libmad's fixed decoder delay, on top of the encoder delay in the LAME tag
+	static const int DecoderDelay = 529;
+
 	void _initMAD();
 	void _finishMAD();
-	short _fixedToShort(mad_fixed_t Fixed);
+	static short _fixedToShort(mad_fixed_t Fixed);
+	static void _convert(const mad_fixed_t *left, const mad_fixed_t *right, short *out, int count);
+	static void _convert(const mad_fixed_t *left, const mad_fixed_t *right, float *out, int count);
+	template<class T> int _decode(T *sampleBuffer, int maxSamples);
+	bool _buildIndex();
+	bool _readAt(uint64_t offset, unsigned char *dst, size_t size);
+	static bool _parseHeader(const unsigned char *h, FrameHeader &header);
 
 	ifstream fin;
 	unsigned char inputBuffer[MAD_INPUT_BUFFER_SIZE + MAD_BUFFER_GUARD];
@@ -47,4 +84,13 @@ private:
 	mad_timer_t timer;
 	int synthSampleOffset;
 	int synthSampleCount;
+
+	vector<uint32_t> _frames; // byte offset of every audio frame, in order
+	int _samplesPerFrame;
+	unsigned int _sampleRate;
+	unsigned short _channels;
+	uint64_t _begin;    // first sample after the encoder and decoder delay
+	uint64_t _end;      // one past the last sample before the padding
+	uint64_t _position; // decoded position, including the delay
+	uint64_t _skipUntil;
 };
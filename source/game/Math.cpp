@@ -62,12 +62,6 @@ void mat3f::Set(float _11, float _21, float _31,
 	m13 = _13; m23 = _23; m33 = _33;
 }
 
-vec2f mat3f::operator*(const vec2f &V) const
-{
-	return vec2f(m11 * V.x + m21 * V.y + m31,
-					m12 * V.x + m22 * V.y + m32);
-}
-
 vec3f mat3f::operator*(const vec3f &V) const
 {
 	return vec3f(m11 * V.x + m21 * V.y + m31 * V.z,
@@ -640,182 +634,6 @@ const vec2f vec2f::right(1, 0);
 const vec2f vec2f::zero(0, 0);
 const vec2f vec2f::one(1, 1);
 
-vec2f::vec2f(const mat3f &mtx, const vec2f &vec)
-{
-	x = mtx.m11 * vec.x + mtx.m21 * vec.y + mtx.m31;
-	y = mtx.m12 * vec.x + mtx.m22 * vec.y + mtx.m32;
-}
-
-vec2f::vec2f(const mat3f &mtx, float x, float y)
-{
-	this->x = mtx.m11 * x + mtx.m21 * y + mtx.m31;
-	this->y = mtx.m12 * x + mtx.m22 * y + mtx.m32;
-}
-
-vec2f vec2f::operator+(const vec2f &vec) const
-{
-	return vec2f(x + vec.x, y + vec.y);
-}
-vec2f vec2f::operator-(const vec2f &vec) const
-{
-	return vec2f(x - vec.x, y - vec.y);
-}
-vec2f vec2f::operator-() const
-{
-	return vec2f(-x, -y);
-}
-vec2f vec2f::operator*(const float scalar) const
-{
-	return vec2f(x * scalar, y * scalar);
-}
-float vec2f::operator*(const vec2f &vec) const
-{
-	return x * vec.x + y * vec.y;
-}
-vec2f vec2f::operator/(const float scalar) const
-{
-	return vec2f(x / scalar, y / scalar);
-}
-vec2f &vec2f::operator+=(const vec2f &vec)
-{
-	x += vec.x;
-	y += vec.y;
-	return *this;
-}
-vec2f &vec2f::operator-=(const vec2f &vec)
-{
-	x -= vec.x;
-	y -= vec.y;
-	return *this;
-}
-vec2f &vec2f::operator*=(const float scalar)
-{
-	x *= scalar;
-	y *= scalar;
-	return *this;
-}
-vec2f vec2f::operator*(const mat3f &M) const
-{
-	return vec2f(x * M.m11 + y * M.m12 + M.m13,
-				x * M.m21 + y * M.m22 + M.m23);
-}
-vec2f &vec2f::operator*=(const mat3f &M)
-{
-	return *this = vec2f(x * M.m11 + y * M.m12 + M.m13,
-						x * M.m21 + y * M.m22 + M.m23);
-}
-vec2f vec2f::operator*(const mat4f &M) const
-{
-	return vec2f(x * M.m11 + y * M.m12 + M.m14,
-				x * M.m21 + y * M.m22 + M.m24);
-}
-vec2f &vec2f::operator*=(const mat4f &M)
-{
-	return *this = vec2f(x * M.m11 + y * M.m12 + M.m14,
-						x * M.m21 + y * M.m22 + M.m24);
-}
-void vec2f::LeftTransform(const mat3f &M, vec2f &V)
-{
-	x = M.m11 * V.x + M.m21 * V.y + M.m31;
-	y = M.m12 * V.x + M.m22 * V.y + M.m32;
-}
-void vec2f::LeftTransform(const mat4f &M, vec2f &V)
-{
-	x = M.m11 * V.x + M.m21 * V.y + M.m41;
-	y = M.m12 * V.x + M.m22 * V.y + M.m42;
-}
-vec2f &vec2f::operator/=(const float scalar)
-{
-	x /= scalar;
-	y /= scalar;
-	return *this;
-}
-bool vec2f::operator==(const vec2f &vec) const
-{
-	return (x == vec.x && y == vec.y);
-}
-bool vec2f::operator!=(const vec2f &vec) const
-{
-	return (x != vec.x || y != vec.y);
-}
-	
-vec2f vec2f::PerpCW() const
-{
-	return vec2f(-y, x);
-}
-
-vec2f vec2f::PerpCCW() const
-{
-	return vec2f(y, -x);
-}
-
-float vec2f::Distance(const vec2f &vec) const
-{
-	vec2f dvec(vec.x - x, vec.y - y);
-	return sqrt((dvec.x * dvec.x) + (dvec.y * dvec.y));
-}
-float vec2f::DistanceSq(const vec2f &vec) const
-{
-	vec2f dvec(vec.x - x, vec.y - y);
-	return (dvec.x * dvec.x) + (dvec.y * dvec.y);
-}
-float vec2f::Length() const
-{
-	return sqrtf((x * x) + (y * y));
-}
-float vec2f::LengthSq() const
-{
-	return (x * x) + (y * y);
-}
-float vec2f::Cross(const vec2f &vec) const
-{
-	return x * vec.y - vec.x * y;
-}
-
-float vec2f::Dot(const vec2f &other) const
-{
-	return x * other.x + y * other.y;
-}
-
-// normalize vector , doesn't return or save the length
-void vec2f::Normalize()
-{
-	float length = sqrtf(x * x + y * y);
-	if(length > 0)
-	{
-		x /= length;
-		y /= length;
-	}
-}
-
-vec2f vec2f::Normalized() const
-{
-	float len = sqrt(x * x + y * y);
-	return len > 0 ? vec2f(x / len, y / len) : vec2f::zero;
-}
-
-void vec2f::Reverse()
-{
-	x = -x;
-	y = -y;
-}
-
-float vec2f::Angle(const vec2f &other) const
-{
-	return acos(Normalized().Dot(other.Normalized()));
-}
-
-vec2f vec2f::Project(const vec2f &v) const
-{
-	return v * this->Dot(v) / v.Dot(v);
-}
-
-vec2f vec2f::SignedProject(const vec2f &v) const
-{
-	float d = this->Dot(v);
-	return d > 0 ? v * d / v.Dot(v) : vec2f::zero;
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 //    vec3f
 ///////////////////////////////////////////////////////////////////////////////
@@ -1574,31 +1392,3 @@ uint32_t Color::RGBA(uint8_t r, uint8_t g, uint8_t b,  uint8_t a)
 	
 	return red | grn | blu | alp;
 }
-
-/////////////////////
-
-float _invRandMax = 1.0f / (float)RAND_MAX;
-
-float Random::value()
-{
-	return (float)rand() * _invRandMax;
-}
-
-float Random::signedValue()
-{
-	return (float)rand() * _invRandMax * 2.0f - 1.0f;
-}
-
-vec2f Random::vector2()
-{
-	float a = value() * math::twopi;
-	float r = value() + value();
-	r = r > 1 ? 2 - r : r;
-
-	return vec2f(r * cos(a), r * sin(a));
-}
-
-float Random::range(float min, float max)
-{
-	return min + (float)rand() * _invRandMax * (max - min);
-}
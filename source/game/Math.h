@@ -322,6 +322,188 @@ public:
 	vec2f SignedProject(const vec2f &v) const;
 };
 
+inline vec2f mat3f::operator*(const vec2f &V) const
+{
+	return vec2f(m11 * V.x + m21 * V.y + m31,
+					m12 * V.x + m22 * V.y + m32);
+}
+
+inline vec2f::vec2f(const mat3f &mtx, const vec2f &vec)
+{
+	x = mtx.m11 * vec.x + mtx.m21 * vec.y + mtx.m31;
+	y = mtx.m12 * vec.x + mtx.m22 * vec.y + mtx.m32;
+}
+
+inline vec2f::vec2f(const mat3f &mtx, float x, float y)
+{
+	this->x = mtx.m11 * x + mtx.m21 * y + mtx.m31;
+	this->y = mtx.m12 * x + mtx.m22 * y + mtx.m32;
+}
+
+inline vec2f vec2f::operator+(const vec2f &vec) const
+{
+	return vec2f(x + vec.x, y + vec.y);
+}
+inline vec2f vec2f::operator-(const vec2f &vec) const
+{
+	return vec2f(x - vec.x, y - vec.y);
+}
+inline vec2f vec2f::operator-() const
+{
+	return vec2f(-x, -y);
+}
+inline vec2f vec2f::operator*(const float scalar) const
+{
+	return vec2f(x * scalar, y * scalar);
+}
+inline float vec2f::operator*(const vec2f &vec) const
+{
+	return x * vec.x + y * vec.y;
+}
+inline vec2f vec2f::operator/(const float scalar) const
+{
+	return vec2f(x / scalar, y / scalar);
+}
+inline vec2f &vec2f::operator+=(const vec2f &vec)
+{
+	x += vec.x;
+	y += vec.y;
+	return *this;
+}
+inline vec2f &vec2f::operator-=(const vec2f &vec)
+{
+	x -= vec.x;
+	y -= vec.y;
+	return *this;
+}
+inline vec2f &vec2f::operator*=(const float scalar)
+{
+	x *= scalar;
+	y *= scalar;
+	return *this;
+}
+inline vec2f vec2f::operator*(const mat3f &M) const
+{
+	return vec2f(x * M.m11 + y * M.m12 + M.m13,
+				x * M.m21 + y * M.m22 + M.m23);
+}
+inline vec2f &vec2f::operator*=(const mat3f &M)
+{
+	return *this = vec2f(x * M.m11 + y * M.m12 + M.m13,
+						x * M.m21 + y * M.m22 + M.m23);
+}
+inline vec2f vec2f::operator*(const mat4f &M) const
+{
+	return vec2f(x * M.m11 + y * M.m12 + M.m14,
+				x * M.m21 + y * M.m22 + M.m24);
+}
+inline vec2f &vec2f::operator*=(const mat4f &M)
+{
+	return *this = vec2f(x * M.m11 + y * M.m12 + M.m14,
+						x * M.m21 + y * M.m22 + M.m24);
+}
+inline void vec2f::LeftTransform(const mat3f &M, vec2f &V)
+{
+	x = M.m11 * V.x + M.m21 * V.y + M.m31;
+	y = M.m12 * V.x + M.m22 * V.y + M.m32;
+}
+inline void vec2f::LeftTransform(const mat4f &M, vec2f &V)
+{
+	x = M.m11 * V.x + M.m21 * V.y + M.m41;
+	y = M.m12 * V.x + M.m22 * V.y + M.m42;
+}
+inline vec2f &vec2f::operator/=(const float scalar)
+{
+	x /= scalar;
+	y /= scalar;
+	return *this;
+}
+inline bool vec2f::operator==(const vec2f &vec) const
+{
+	return (x == vec.x && y == vec.y);
+}
+inline bool vec2f::operator!=(const vec2f &vec) const
+{
+	return (x != vec.x || y != vec.y);
+}
+
+inline vec2f vec2f::PerpCW() const
+{
+	return vec2f(-y, x);
+}
+
+inline vec2f vec2f::PerpCCW() const
+{
+	return vec2f(y, -x);
+}
+
+inline float vec2f::Distance(const vec2f &vec) const
+{
+	vec2f dvec(vec.x - x, vec.y - y);
+	return sqrtf((dvec.x * dvec.x) + (dvec.y * dvec.y));
+}
+inline float vec2f::DistanceSq(const vec2f &vec) const
+{
+	vec2f dvec(vec.x - x, vec.y - y);
+	return (dvec.x * dvec.x) + (dvec.y * dvec.y);
+}
+inline float vec2f::Length() const
+{
+	return sqrtf((x * x) + (y * y));
+}
+inline float vec2f::LengthSq() const
+{
+	return (x * x) + (y * y);
+}
+inline float vec2f::Cross(const vec2f &vec) const
+{
+	return x * vec.y - vec.x * y;
+}
+
+inline float vec2f::Dot(const vec2f &other) const
+{
+	return x * other.x + y * other.y;
+}
+
+// normalize vector , doesn't return or save the length
+inline void vec2f::Normalize()
+{
+	float length = sqrtf(x * x + y * y);
+	if(length > 0)
+	{
+		x /= length;
+		y /= length;
+	}
+}
+
+inline vec2f vec2f::Normalized() const
+{
+	float len = sqrtf(x * x + y * y);
+	return len > 0 ? vec2f(x / len, y / len) : vec2f::zero;
+}
+
+inline void vec2f::Reverse()
+{
+	x = -x;
+	y = -y;
+}
+
+inline float vec2f::Angle(const vec2f &other) const
+{
+	return acos(Normalized().Dot(other.Normalized()));
+}
+
+inline vec2f vec2f::Project(const vec2f &v) const
+{
+	return v * this->Dot(v) / v.Dot(v);
+}
+
+inline vec2f vec2f::SignedProject(const vec2f &v) const
+{
+	float d = this->Dot(v);
+	return d > 0 ? v * d / v.Dot(v) : vec2f::zero;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //    vec3f
 ///////////////////////////////////////////////////////////////////////////////
@@ -625,11 +807,3 @@ public:
 
 	static uint32_t RGBA(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
 };
-
-struct Random
-{
-	static float value();
-	static float signedValue();
-	static vec2f vector2();
-	static float range(float min, float max);
-};
@@ -0,0 +1,93 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <cstddef>
+#include "Math.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define MATH_SSE2
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+  #define MATH_NEON
+  #include <arm_neon.h>
+#endif
+
+// the kernels below read and write vec2f arrays as packed x,y floats
+static_assert(sizeof(vec2f) == 2 * sizeof(float), "vec2f must be tightly packed");
+
+namespace math
+{
+	// out[i] = vec2f(mtx, in[i]). 'in' and 'out' may be the same array.
+	inline void TransformPoints(const mat3f &mtx, const vec2f *in, vec2f *out, size_t count)
+	{
+		size_t i = 0;
+
+	#if defined(MATH_SSE2)
+		const __m128 c1 = _mm_setr_ps(mtx.m11, mtx.m12, mtx.m11, mtx.m12);
+		const __m128 c2 = _mm_setr_ps(mtx.m21, mtx.m22, mtx.m21, mtx.m22);
+		const __m128 c3 = _mm_setr_ps(mtx.m31, mtx.m32, mtx.m31, mtx.m32);
+
+		for( ; i + 2 <= count; i += 2)
+		{
+			__m128 v = _mm_loadu_ps(&in[i].x);
+			__m128 xx = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+			__m128 yy = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+			__m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, c1), _mm_mul_ps(yy, c2)), c3);
+			_mm_storeu_ps(&out[i].x, r);
+		}
+	#elif defined(MATH_NEON)
+		const float32x4_t c3x = vdupq_n_f32(mtx.m31);
+		const float32x4_t c3y = vdupq_n_f32(mtx.m32);
+
+		for( ; i + 4 <= count; i += 4)
+		{
+			float32x4x2_t v = vld2q_f32(&in[i].x);
+			float32x4x2_t r;
+			r.val[0] = vmlaq_n_f32(vmlaq_n_f32(c3x, v.val[0], mtx.m11), v.val[1], mtx.m21);
+			r.val[1] = vmlaq_n_f32(vmlaq_n_f32(c3y, v.val[0], mtx.m12), v.val[1], mtx.m22);
+			vst2q_f32(&out[i].x, r);
+		}
+	#endif
+
+		for( ; i < count; ++i)
+			out[i] = vec2f(mtx, in[i]);
+	}
+
+	// out[i] = from.Distance(points[i])
+	inline void Distances(const vec2f &from, const vec2f *points, float *out, size_t count)
+	{
+		size_t i = 0;
+
+	#if defined(MATH_SSE2)
+		const __m128 fx = _mm_set1_ps(from.x);
+		const __m128 fy = _mm_set1_ps(from.y);
+
+		for( ; i + 4 <= count; i += 4)
+		{
+			__m128 a = _mm_loadu_ps(&points[i].x);
+			__m128 b = _mm_loadu_ps(&points[i + 2].x);
+			__m128 dx = _mm_sub_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), fx);
+			__m128 dy = _mm_sub_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)), fy);
+			__m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+			_mm_storeu_ps(out + i, _mm_sqrt_ps(d2));
+		}
+	#elif defined(MATH_NEON)
+		const float32x4_t fx = vdupq_n_f32(from.x);
+		const float32x4_t fy = vdupq_n_f32(from.y);
+
+		for( ; i + 4 <= count; i += 4)
+		{
+			float32x4x2_t v = vld2q_f32(&points[i].x);
+			float32x4_t dx = vsubq_f32(v.val[0], fx);
+			float32x4_t dy = vsubq_f32(v.val[1], fy);
+			vst1q_f32(out + i, vsqrtq_f32(vmlaq_f32(vmulq_f32(dx, dx), dy, dy)));
+		}
+	#endif
+
+		for( ; i < count; ++i)
+			out[i] = from.Distance(points[i]);
+	}
+}
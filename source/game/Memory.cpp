@@ -0,0 +1,116 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "Memory.h"
+#include <Windows.h>
+#include <Psapi.h>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+
+#pragma comment(lib, "psapi.lib")
+
+using namespace std;
+
+#if PQ_COUNT_ALLOCATIONS
+
+// constant initialized, so they're ready before any static constructor allocates
+static atomic<uint64_t> _allocations(0);
+static atomic<uint64_t> _allocatedBytes(0);
+
+static void *_allocate(size_t size)
+{
+	_allocations.fetch_add(1, memory_order_relaxed);
+	_allocatedBytes.fetch_add(size, memory_order_relaxed);
+	return malloc(size ? size : 1);
+}
+
+void *operator new(size_t size)
+{
+	void *p = _allocate(size);
+	if(!p) throw bad_alloc();
+	return p;
+}
+
+void *operator new[](size_t size)
+{
+	void *p = _allocate(size);
+	if(!p) throw bad_alloc();
+	return p;
+}
+
+void *operator new(size_t size, const nothrow_t&) noexcept
+{
+	return _allocate(size);
+}
+
+void *operator new[](size_t size, const nothrow_t&) noexcept
+{
+	return _allocate(size);
+}
+
+void operator delete(void *p) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void *p, const nothrow_t&) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void *p, const nothrow_t&) noexcept
+{
+	free(p);
+}
+
+uint64_t Memory::allocations()
+{
+	return _allocations.load(memory_order_relaxed);
+}
+
+uint64_t Memory::allocatedBytes()
+{
+	return _allocatedBytes.load(memory_order_relaxed);
+}
+
+#else
+
+uint64_t Memory::allocations()
+{
+	return 0;
+}
+
+uint64_t Memory::allocatedBytes()
+{
+	return 0;
+}
+
+#endif
+
+uint64_t Memory::workingSet()
+{
+	PROCESS_MEMORY_COUNTERS counters;
+
+	if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+
+	return counters.WorkingSetSize;
+}
+
+uint64_t Memory::peakWorkingSet()
+{
+	PROCESS_MEMORY_COUNTERS counters;
+
+	if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+
+	return counters.PeakWorkingSetSize;
+}
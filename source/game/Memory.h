@@ -0,0 +1,31 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <cstdint>
+
+// build with PQ_COUNT_ALLOCATIONS=1 to count allocations, for benchmark runs
+#ifndef PQ_COUNT_ALLOCATIONS
+#define PQ_COUNT_ALLOCATIONS 0
+#endif
+
+// Process wide memory statistics. When allocations are counted, the global
+// operator new is replaced and every allocation costs two relaxed atomic adds
+// on top of malloc. Third party code allocating with malloc directly, like
+// Box2D, isn't counted. Otherwise allocations() and allocatedBytes() are 0.
+class Memory
+{
+public:
+	static bool countingAllocations() {
+		return PQ_COUNT_ALLOCATIONS != 0;
+	}
+
+	static uint64_t allocations();
+	static uint64_t allocatedBytes();
+
+	// working set of the process in bytes, now and at its highest so far
+	static uint64_t workingSet();
+	static uint64_t peakWorkingSet();
+};
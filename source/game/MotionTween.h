@@ -39,6 +39,7 @@ public:
 	~MotionTween();
 
 	virtual void Update();
+	virtual UpdatePhase threadSafePhases() const override { return UpdatePhase::Update; }
 
 	void SetLoop(const deque<vec2f> &loop, float speed);
 	void SetPath(vec2f &startPos, const deque<vec2f> &path, float speed);
@@ -7,6 +7,99 @@
 #include "State.h"
 #include "Engine.h"
 
+Object::Object()
+	: _registry(nullptr), _phases(UpdatePhase::All), _cullHandle(0xFFFFFFFF), _boundsDirty(false), _classCounter(-1),
+	  type(0), layer(DrawLayer::Bottom), category(0)
+{
+	for(auto &slot : _slots)
+		slot = 0xFFFFFFFF;
+
+	for(int i = 0; i < 2; ++i)
+	{
+		_parallelBucket[i] = 0xFFFFFFFF;
+		_parallelSlot[i] = 0xFFFFFFFF;
+	}
+}
+
+Object::~Object()
+{
+	if(_registry)
+		_registry->Detach(this);
+}
+
+void Object::_OnAttached()
+{
+	auto p = _parent.lock();
+
+	if(p && p->_registry)
+		p->_registry->Attach(this);
+}
+
+void Object::_OnDetached()
+{
+	if(_registry)
+		_registry->Detach(this);
+}
+
+void Object::Update()
+{
+	_PhaseUnused(UpdatePhase::Update);
+}
+
+void Object::LateUpdate()
+{
+	_PhaseUnused(UpdatePhase::LateUpdate);
+}
+
+void Object::PreDrawUpdate()
+{
+	_PhaseUnused(UpdatePhase::PreDrawUpdate);
+}
+
+void Object::Draw()
+{
+	_PhaseUnused(UpdatePhase::Draw);
+}
+
+void Object::_PhaseUnused(UpdatePhase phase)
+{
+	// the parallel buckets can't change while they run, those objects
+	// just keep getting the empty call
+	if(ParallelUpdateSet::running())
+		return;
+
+	_phases &= ~phase;
+
+	if(_registry)
+		_registry->PhaseUnused(this, phase);
+}
+
+void Object::_AddTask(const shared_ptr<Task> &task)
+{
+	// the task list and registry belong to the main thread, the task is
+	// added once the main thread takes the post, if the object's still alive
+	if(!Engine::onMainThread())
+	{
+		weak_ptr<Object> self = shared_from_this();
+		Engine::Post([self, task]{
+			if(auto obj = self.lock())
+				obj->_AddTask(task);
+		});
+		return;
+	}
+
+	tasks.push_back(task);
+
+	if(_registry)
+		_registry->TaskAdded(this);
+}
+
+shared_ptr<Arena> Object::_arena()
+{
+	auto s = state();
+	return s ? s->arena : shared_ptr<Arena>();
+}
+
 bool Object::isRootTopState()
 {
 	return root() == Engine::GetState();
@@ -15,14 +108,14 @@ bool Object::isRootTopState()
 weak_ptr<Task> Object::RunAfterUpdate(const function<void()> &fx)
 {
 	auto ret = make_shared<InvokeTask>(fx);
-	tasks.push_back(ret);
+	_AddTask(ret);
 	return ret;
 }
 
 weak_ptr<Task> Object::RunAfterDelay(const function<void()> &fx, float delay)
 {
 	auto ret = make_shared<DelayedTask>(fx, Time::exactTime() + delay);
-	tasks.push_back(ret);
+	_AddTask(ret);
 	return ret;
 }
 
@@ -30,8 +123,20 @@ weak_ptr<Task> Object::RunCoroutine(const function<void(yield_token<float>)> &fx
 {
 	shared_ptr<Task> ret = make_shared<CoroutineTask>(fx);
 
+	// the coroutine starts on the main thread too
+	if(!Engine::onMainThread())
+	{
+		weak_ptr<Object> self = shared_from_this();
+		Engine::Post([self, ret]{
+			auto obj = self.lock();
+			if(obj && ret->Execute())
+				obj->_AddTask(ret);
+		});
+		return ret;
+	}
+
 	if(ret->Execute())
-		tasks.push_back(ret);
+		_AddTask(ret);
 	else
 		ret.reset();
 
@@ -45,3 +150,28 @@ void Object::CancelTask(const weak_ptr<Task> &stub)
 	if(it != tasks.end())
 		tasks.erase(it);
 }
+
+void Object::BoundsChanged()
+{
+	if(_registry && !_boundsDirty && (_phases & UpdatePhase::Draw) != UpdatePhase::None)
+	{
+		_boundsDirty = true;
+		_registry->BoundsChanged(this);
+	}
+}
+
+void Object::Defer(const function<void()> &fx)
+{
+	if(ParallelUpdateSet::running())
+		deferred.push_back(fx);
+	else
+		fx();
+}
+
+void Object::TakeDeferred(vector<function<void()>> &commands)
+{
+	for(auto &fx : deferred)
+		commands.push_back(move(fx));
+
+	deferred.clear();
+}
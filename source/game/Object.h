@@ -12,6 +12,8 @@
 #include "Physics.h"
 #include "RenderQueue.h"
 #include "Task.h"
+#include "ObjectRegistry.h"
+#include "Arena.h"
 #include <functional>
 #include <coroutine.h>
 using namespace coroutines;
@@ -19,33 +21,86 @@ using namespace std;
 class Engine;
 class State;
 
+enum class BoundsType
+{
+	None,   // always drawn
+	Culled, // culled, call BoundsChanged() whenever the bounds change
+};
+
 class Object : public enable_shared_from_this<Object>
 {
 	friend class Engine;
+	friend class ObjectRegistry;
+	friend class ParallelUpdateSet;
+
+	ObjectRegistry *_registry;
+	UpdatePhase _phases;
+	uint32_t _slots[ObjectRegistry::ListCount];
+	uint32_t _parallelBucket[2]; // ParallelUpdateSet bucket and slot, for
+	uint32_t _parallelSlot[2];   // Update and LateUpdate
+	uint32_t _cullHandle;
+	bool _boundsDirty;
+	int _classCounter;
+
 protected:
 	weak_ptr<Object> _parent;
 	vector<shared_ptr<Object>> _children;
 	vector<shared_ptr<Task>> tasks;
+	vector<function<void()>> deferred;
+
+	void _OnAttached();
+	void _OnDetached();
+	void _PhaseUnused(UpdatePhase phase);
+	void _AddTask(const shared_ptr<Task> &task);
+	shared_ptr<Arena> _arena();
 	
 public:
 	unsigned char type; // only used for map loading
 	DrawLayer layer; // render sorting layer
 	uint32_t category; // render pass category
 
-	Object() : type(0), layer(DrawLayer::Bottom), category(0){}
-	virtual ~Object(){}
+	Object();
+	virtual ~Object();
 	
 	virtual void Start(){}
-	virtual void Update(){}
-	virtual void LateUpdate(){}
-	virtual void PreDrawUpdate(){}
-	virtual void Draw(){}
+
+	// the defaults take the object off their phase's list the first time
+	// they're called, so only the phases a class overrides keep running.
+	// Every object pays one wasted virtual call for each phase it doesn't use.
+	virtual void Update();
+	virtual void LateUpdate();
+	virtual void PreDrawUpdate();
+	virtual void Draw();
+
 	virtual void OnCollisionEnter(Contact contact){}
 	virtual void OnCollisionExit(Contact contact){}
 	
 	virtual string tag() const {
 		return "Object";
 	}
+
+	// Phases in which Update()/LateUpdate() may run on a pool thread, concurrently
+	// with other thread-safe objects. Those calls may only modify the object itself
+	// and its own children; everything else has to go through Defer().
+	virtual UpdatePhase threadSafePhases() const {
+		return UpdatePhase::None;
+	}
+
+	// World space rect the object draws into. Drawable objects that have one
+	// are kept in their registry's spatial hash and never submitted while
+	// they're off screen.
+	virtual BoundsType GetBounds(Rect &bounds) {
+		return BoundsType::None;
+	}
+
+	// the bounds are read again before the next draw. Safe in a parallel
+	// phase, for the object itself and its children.
+	void BoundsChanged();
+
+	// true while the object is in its registry's spatial hash
+	bool culled() const {
+		return _cullHandle != 0xFFFFFFFF;
+	}
 	
 	bool isRootTopState();
 
@@ -79,6 +134,13 @@ public:
 		return _children;
 	}
 
+	// creates a T in the owning state's arena, or on the heap if there is none
+	template<class T, class... Args>
+	shared_ptr<T> New(Args&&... args)
+	{
+		return make_pooled<T>(_arena(), std::forward<Args>(args)...);
+	}
+
 	template<class T>
 	shared_ptr<T> as()
 	{
@@ -93,11 +155,12 @@ public:
 		
 		_children.push_back(child);
 		child->_parent = shared_from_this();
+		child->_OnAttached();
 		
 		if(isRootTopState())
 			child->Start();
 		else
-			tasks.emplace_back(new ObjectStartTask(child));
+			_AddTask(make_shared<ObjectStartTask>(child));
 
 		return child;
 	}
@@ -110,6 +173,7 @@ public:
 		{
 			if(*it == child)
 			{
+				child->_OnDetached();
 				child->_parent.reset();
 				_children.erase(it);
 				break;
@@ -125,6 +189,7 @@ public:
 		{
 			if(it->get() == child)
 			{
+				(*it)->_OnDetached();
 				(*it)->_parent.reset();
 				_children.erase(it);
 				break;
@@ -132,53 +197,6 @@ public:
 		}
 	}
 	
-	void RunTasks_R()
-	{
-		for(auto it = tasks.begin(); it != tasks.end(); )
-		{
-			if((*it)->Execute())
-				++it;
-			else
-				it = tasks.erase(it);
-		}
-
-		for(size_t i = 0; i < _children.size(); ++i)
-			_children[i]->RunTasks_R();
-	}
-
-	void Update_R()
-	{
-		Update();
-
-		for(size_t i = 0; i < _children.size(); ++i)
-			_children[i]->Update_R();
-	}
-
-	void LateUpdate_R()
-	{
-		LateUpdate();
-
-		for(size_t i = 0; i < _children.size(); ++i)
-			_children[i]->LateUpdate_R();
-	}
-
-	void PreDrawUpdate_R()
-	{
-		PreDrawUpdate();
-		
-		for(auto& c : _children)
-			c->PreDrawUpdate_R();
-	}
-
-	void SubmitDrawCalls_R(uint32_t mask /* = 0xFFFFFFFF */)
-	{
-		if(category & mask)
-			RenderQueue::Submit(this);
-
-		for(auto& c : _children)
-			c->SubmitDrawCalls_R(mask);
-	}
-	
 	template<class FN>
 	void RecursiveTransform(FN visitor)
 	{
@@ -190,12 +208,21 @@ public:
 	{
 		visitor(this);
 
-		for(size_t i = 0; i < children.size(); ++i)
+		for(size_t i = 0; i < _children.size(); ++i)
 			_children[i]->RecursiveTransform_R(visitor);
 	}
 
+	// safe from any thread, off the main thread the task is posted and only
+	// added at the start of the next frame
 	weak_ptr<Task> RunAfterUpdate(const function<void()> &fx);
 	weak_ptr<Task> RunAfterDelay(const function<void()> &fx, float delay);
 	weak_ptr<Task> RunCoroutine(const function<void(yield_token<float>)> &fx);
 	void CancelTask(const weak_ptr<Task> &task);
+
+	// runs fx on the main thread once the current parallel phase is over,
+	// or immediately when called outside of one
+	void Defer(const function<void()> &fx);
+
+	// moves the deferred functions to the end of 'commands' without running them
+	void TakeDeferred(vector<function<void()>> &commands);
 };
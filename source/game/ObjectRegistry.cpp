@@ -0,0 +1,385 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "ObjectRegistry.h"
+#include "Object.h"
+#include "RenderQueue.h"
+#include "Counters.h"
+#include <unordered_map>
+#include <typeindex>
+#include <cstring>
+#include <algorithm>
+
+static const uint32_t NotListed = 0xFFFFFFFF;
+
+// a gauge per class, like "objects.PQTile", of the attached objects. Shared
+// by every EngineContext, which may attach objects at the same time.
+static int ClassCounter(Object *obj)
+{
+	static mutex lock;
+	static unordered_map<type_index, int> ids;
+
+	lock_guard<mutex> lk(lock);
+
+	type_index type(typeid(*obj));
+	auto it = ids.find(type);
+
+	if(it != ids.end())
+		return it->second;
+
+	string name = type.name();
+
+	for(const char *prefix : { "class ", "struct " })
+	{
+		if(name.compare(0, strlen(prefix), prefix) == 0)
+			name.erase(0, strlen(prefix));
+	}
+
+	int id = Counters::Register("objects." + name, Counters::Kind::Gauge);
+	ids.emplace(type, id);
+
+	return id;
+}
+
+void ObjectRegistry::Attach(Object *obj)
+{
+	obj->RecursiveTransform_R([this](Object *o){ _attach(o); });
+}
+
+void ObjectRegistry::Detach(Object *obj)
+{
+	obj->RecursiveTransform_R([this](Object *o){ _detach(o); });
+}
+
+void ObjectRegistry::_attach(Object *obj)
+{
+	if(obj->_registry)
+		return;
+
+	obj->_registry = this;
+
+	if(obj->_classCounter == -1)
+		obj->_classCounter = ClassCounter(obj);
+
+	Counters::Add(obj->_classCounter, 1);
+
+	UpdatePhase phases = obj->_phases;
+	UpdatePhase threadSafe = obj->threadSafePhases() & phases;
+
+	if(threadSafe != UpdatePhase::None)
+		_parallel.Add(obj, threadSafe);
+
+	if((phases & ~threadSafe & UpdatePhase::Update) != UpdatePhase::None)
+		_add(UpdateList, obj);
+
+	if((phases & ~threadSafe & UpdatePhase::LateUpdate) != UpdatePhase::None)
+		_add(LateUpdateList, obj);
+
+	if((phases & UpdatePhase::PreDrawUpdate) != UpdatePhase::None)
+		_add(PreDrawUpdateList, obj);
+
+	if((phases & UpdatePhase::Draw) != UpdatePhase::None)
+		_updateBounds(obj);
+
+	if(!obj->tasks.empty())
+		_add(TaskList, obj);
+}
+
+void ObjectRegistry::_detach(Object *obj)
+{
+	if(obj->_registry != this)
+		return;
+
+	for(int i = 0; i < ListCount; ++i)
+		_remove((ListID)i, obj);
+
+	if(obj->_cullHandle != NotListed)
+	{
+		_culled.Remove(obj->_cullHandle);
+		obj->_cullHandle = NotListed;
+	}
+
+	_parallel.Remove(obj);
+
+	if(obj->_boundsDirty)
+	{
+		_parallelBounds.erase(remove(_parallelBounds.begin(), _parallelBounds.end(), obj), _parallelBounds.end());
+		obj->_boundsDirty = false;
+	}
+
+	Counters::Add(obj->_classCounter, -1);
+
+	obj->_registry = nullptr;
+}
+
+void ObjectRegistry::TaskAdded(Object *obj)
+{
+	if(obj->_slots[TaskList] == NotListed)
+		_add(TaskList, obj);
+}
+
+void ObjectRegistry::PhaseUnused(Object *obj, UpdatePhase phase)
+{
+	if(obj->_registry != this)
+		return;
+
+	switch(phase)
+	{
+	case UpdatePhase::Update:
+		_remove(UpdateList, obj);
+		break;
+
+	case UpdatePhase::LateUpdate:
+		_remove(LateUpdateList, obj);
+		break;
+
+	case UpdatePhase::PreDrawUpdate:
+		_remove(PreDrawUpdateList, obj);
+		break;
+
+	case UpdatePhase::Draw:
+		_remove(DrawList, obj);
+		_remove(BoundsList, obj);
+
+		if(obj->_cullHandle != NotListed)
+		{
+			_culled.Remove(obj->_cullHandle);
+			obj->_cullHandle = NotListed;
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void ObjectRegistry::BoundsChanged(Object *obj)
+{
+	if(ParallelUpdateSet::running())
+	{
+		lock_guard<mutex> lk(_boundsLock);
+		_parallelBounds.push_back(obj);
+	}
+	else
+	{
+		_add(BoundsList, obj);
+	}
+}
+
+void ObjectRegistry::_updateBounds(Object *obj)
+{
+	Rect bounds;
+	BoundsType type = obj->GetBounds(bounds);
+
+	if(type == BoundsType::None)
+	{
+		if(obj->_cullHandle != NotListed)
+		{
+			_culled.Remove(obj->_cullHandle);
+			obj->_cullHandle = NotListed;
+		}
+
+		if(obj->_slots[DrawList] == NotListed)
+			_add(DrawList, obj);
+
+		return;
+	}
+
+	if(obj->_cullHandle == NotListed)
+	{
+		_remove(DrawList, obj);
+		obj->_cullHandle = _culled.Insert(obj, bounds);
+	}
+	else
+	{
+		_culled.Move(obj->_cullHandle, bounds);
+	}
+}
+
+void ObjectRegistry::_add(ListID id, Object *obj)
+{
+	List &list = _lists[id];
+	obj->_slots[id] = (uint32_t)list.objects.size();
+	list.objects.push_back(obj);
+}
+
+void ObjectRegistry::_remove(ListID id, Object *obj)
+{
+	uint32_t slot = obj->_slots[id];
+
+	if(slot != NotListed)
+	{
+		List &list = _lists[id];
+		list.objects[slot] = nullptr;
+		list.dirty = true;
+		obj->_slots[id] = NotListed;
+	}
+}
+
+void ObjectRegistry::_compact(ListID id)
+{
+	List &list = _lists[id];
+
+	if(!list.dirty)
+		return;
+
+	size_t count = 0;
+
+	for(size_t i = 0; i < list.objects.size(); ++i)
+	{
+		Object *obj = list.objects[i];
+
+		if(obj)
+		{
+			obj->_slots[id] = (uint32_t)count;
+			list.objects[count++] = obj;
+		}
+	}
+
+	list.objects.resize(count);
+	list.dirty = false;
+}
+
+void ObjectRegistry::RunTasks()
+{
+	List &list = _lists[TaskList];
+
+	for(size_t i = 0; i < list.objects.size(); ++i)
+	{
+		Object *obj = list.objects[i];
+		if(!obj) continue;
+
+		// a task may remove the object from the tree
+		auto keepAlive = obj->shared_from_this();
+		auto &tasks = obj->tasks;
+
+		for(auto it = tasks.begin(); it != tasks.end(); )
+		{
+			if((*it)->Execute())
+				++it;
+			else
+				it = tasks.erase(it);
+		}
+
+		if(tasks.empty() && obj->_registry == this)
+			_remove(TaskList, obj);
+	}
+
+	_compact(TaskList);
+}
+
+void ObjectRegistry::Update()
+{
+	List &list = _lists[UpdateList];
+
+	for(size_t i = 0; i < list.objects.size(); ++i)
+	{
+		if(Object *obj = list.objects[i])
+			obj->Update();
+	}
+
+	_compact(UpdateList);
+	_parallel.Run(UpdatePhase::Update);
+}
+
+void ObjectRegistry::LateUpdate()
+{
+	List &list = _lists[LateUpdateList];
+
+	for(size_t i = 0; i < list.objects.size(); ++i)
+	{
+		if(Object *obj = list.objects[i])
+			obj->LateUpdate();
+	}
+
+	_compact(LateUpdateList);
+	_parallel.Run(UpdatePhase::LateUpdate);
+}
+
+void ObjectRegistry::PreDrawUpdate()
+{
+	List &list = _lists[PreDrawUpdateList];
+
+	for(size_t i = 0; i < list.objects.size(); ++i)
+	{
+		if(Object *obj = list.objects[i])
+			obj->PreDrawUpdate();
+	}
+
+	_compact(PreDrawUpdateList);
+
+	// everything has moved for this frame, re-hash what did
+	for(Object *obj : _parallelBounds)
+		_add(BoundsList, obj);
+
+	_parallelBounds.clear();
+
+	List &changed = _lists[BoundsList];
+
+	for(size_t i = 0; i < changed.objects.size(); ++i)
+	{
+		Object *obj = changed.objects[i];
+		if(!obj) continue;
+
+		obj->_slots[BoundsList] = NotListed;
+		obj->_boundsDirty = false;
+
+		if((obj->_phases & UpdatePhase::Draw) != UpdatePhase::None)
+			_updateBounds(obj);
+	}
+
+	changed.objects.clear();
+	changed.dirty = false;
+}
+
+void ObjectRegistry::SubmitDrawCalls(uint32_t mask)
+{
+	_compact(DrawList);
+
+	List &list = _lists[DrawList];
+
+	for(size_t i = 0; i < list.objects.size(); ++i)
+	{
+		Object *obj = list.objects[i];
+
+		if(obj->category & mask)
+			RenderQueue::Submit(obj);
+	}
+
+	_culled.ForEach([mask](Object *obj){
+		if(obj->category & mask)
+			RenderQueue::Submit(obj);
+	});
+}
+
+void ObjectRegistry::SubmitDrawCalls(uint32_t mask, const Rect &view)
+{
+	_compact(DrawList);
+
+	List &list = _lists[DrawList];
+
+	for(size_t i = 0; i < list.objects.size(); ++i)
+	{
+		Object *obj = list.objects[i];
+
+		if(obj->category & mask)
+			RenderQueue::Submit(obj);
+	}
+
+	_culled.Query(view, [mask](Object *obj){
+		if(obj->category & mask)
+			RenderQueue::Submit(obj);
+	});
+}
+
+size_t ObjectRegistry::size(ListID id) const
+{
+	return _lists[id].objects.size();
+}
+
+size_t ObjectRegistry::culledCount() const
+{
+	return _culled.size();
+}
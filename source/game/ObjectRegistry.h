@@ -0,0 +1,88 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include "ParallelUpdateSet.h"
+#include "SpatialHash.h"
+
+using namespace std;
+
+class Object;
+
+// Flat per-phase lists of the objects attached to a State. An object is
+// dropped from a phase the first time the Object default for it runs, and is
+// on the task list only while it has tasks, so the per-frame cost follows the
+// amount of work rather than the size of the tree. Each list runs in the
+// order the objects were attached.
+class ObjectRegistry
+{
+public:
+	enum ListID
+	{
+		TaskList,
+		UpdateList,
+		LateUpdateList,
+		PreDrawUpdateList,
+		DrawList,
+		BoundsList, // objects whose bounds changed since the last PreDrawUpdate
+		ListCount
+	};
+
+private:
+	struct List
+	{
+		List() : dirty(false){}
+
+		vector<Object*> objects; // removed entries are null until the next compaction
+		bool dirty;
+	};
+
+	List _lists[ListCount];
+	ParallelUpdateSet _parallel;
+	SpatialHash _culled; // drawable objects with bounds, instead of the DrawList
+	mutex _boundsLock;
+	vector<Object*> _parallelBounds; // BoundsChanged() during a parallel phase
+
+	void _add(ListID id, Object *obj);
+	void _remove(ListID id, Object *obj);
+	void _compact(ListID id);
+	void _attach(Object *obj);
+	void _detach(Object *obj);
+	void _updateBounds(Object *obj);
+
+public:
+	ObjectRegistry(){}
+	ObjectRegistry(const ObjectRegistry&) = delete;
+	ObjectRegistry &operator=(const ObjectRegistry&) = delete;
+
+	// registers or unregisters 'obj' and all of its descendants
+	void Attach(Object *obj);
+	void Detach(Object *obj);
+
+	// called when an attached object gets a new task
+	void TaskAdded(Object *obj);
+
+	// called by the Object defaults, takes 'obj' off that phase's list
+	void PhaseUnused(Object *obj, UpdatePhase phase);
+
+	// called once per frame by an attached object whose bounds changed,
+	// they're read again at the end of PreDrawUpdate()
+	void BoundsChanged(Object *obj);
+
+	void RunTasks();
+	void Update();
+	void LateUpdate();
+	void PreDrawUpdate();
+	void SubmitDrawCalls(uint32_t mask);
+
+	// submits only the objects that may be visible in 'view', see Object::GetBounds
+	void SubmitDrawCalls(uint32_t mask, const Rect &view);
+
+	size_t size(ListID id) const;
+	size_t culledCount() const;
+};
@@ -0,0 +1,815 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "PQBenchmark.h"
+#include "PQGame.h"
+#include "PQGameLoader.h"
+#include "Memory.h"
+#include "Log.h"
+#include "bytestream.h"
+#include "utils.h"
+#include "MathBatch.h"
+#include "Random.h"
+#include "Audio.h"
+#include "Sound.h"
+#include "MP3Decoder.h"
+#include "ThreadPool.h"
+#include <NPng.h>
+#include <Windows.h>
+#include <sstream>
+#include <fstream>
+#include <thread>
+#include <algorithm>
+#include <cstdio>
+
+// each key is held for 'frames', the script repeats until the scenario ends.
+// E toggles the car when it's released.
+struct ScriptStep
+{
+	KeyCode key;
+	int frames;
+};
+
+static const ScriptStep Script[] =
+{
+	{ KeyCode::W, 120 },
+	{ KeyCode::D, 90 },
+	{ KeyCode::E, 1 },
+	{ KeyCode::W, 150 },
+	{ KeyCode::A, 90 },
+	{ KeyCode::S, 120 },
+	{ KeyCode::E, 1 },
+	{ KeyCode::D, 60 },
+};
+
+static const int ScriptLength = sizeof(Script) / sizeof(Script[0]);
+
+static string JsonString(const string &value)
+{
+	string result = "\"";
+
+	for(char c : value)
+	{
+		if(c == '\\' || c == '"')
+			result += '\\';
+
+		result += c;
+	}
+
+	return result + "\"";
+}
+
+static float Percentile(const vector<float> &sorted, float p)
+{
+	return sorted[(size_t)(p * (float)(sorted.size() - 1) + 0.5f)];
+}
+
+static void SplitList(const string &list, vector<string> &names)
+{
+	istringstream items(list);
+	string name;
+
+	while(getline(items, name, ','))
+	{
+		if(!name.empty())
+			names.push_back(name);
+	}
+}
+
+static double Seconds(long long ticks)
+{
+	return (double)ticks / (double)Time::frequency();
+}
+
+// every file under 'folder' with the extension 'ext', in subfolders too
+static void FindFiles(const string &folder, const string &ext, vector<string> &files)
+{
+	WIN32_FIND_DATAA data;
+	HANDLE find = FindFirstFileA((folder + "\\*").c_str(), &data);
+
+	if(find == INVALID_HANDLE_VALUE)
+		return;
+
+	do
+	{
+		string name = data.cFileName;
+
+		if(name == "." || name == "..")
+			continue;
+
+		string path = folder + "\\" + name;
+
+		if(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		{
+			FindFiles(path, ext, files);
+			continue;
+		}
+
+		size_t dot = name.find_last_of('.');
+		string fileExt = dot == string::npos ? "" : name.substr(dot + 1);
+		transform(fileExt.begin(), fileExt.end(), fileExt.begin(), ::tolower);
+
+		if(fileExt == ext)
+			files.push_back(path);
+	}
+	while(FindNextFileA(find, &data));
+
+	FindClose(find);
+}
+
+// 1, 2, 4... up to the pool's threads or the -benchmark-threads limit
+static vector<int> ThreadCounts(int limit)
+{
+	int most = ThreadPool::workerCount() + 1;
+
+	if(limit > 0)
+		most = min(most, limit);
+
+	vector<int> counts;
+
+	for(int n = 1; n < most; n *= 2)
+		counts.push_back(n);
+
+	counts.push_back(most);
+
+	return counts;
+}
+
+// keeps the results of timed loops alive
+static volatile float Sink;
+
+// GL-free objects for the contexts suite. Each walks from its own stream of
+// its context's Random, so where they end up only depends on the seed.
+class Walker : public Object
+{
+	Rng _rng;
+
+public:
+	vec2f position;
+
+	Walker() : _rng(Random::NewStream()){}
+
+	virtual void Update() override {
+		position += vec2f(_rng.signedValue(), _rng.signedValue()) * (Time::deltaTime() * 100.0f);
+	}
+};
+
+class WalkerState : public State
+{
+public:
+	vector<shared_ptr<Walker>> walkers;
+
+	virtual void Start() override
+	{
+		for(int i = 0; i < 1000; ++i)
+			walkers.push_back(AddChild(New<Walker>()));
+	}
+
+	double checksum() const
+	{
+		double sum = 0;
+
+		for(auto &w : walkers)
+			sum += (double)w->position.x * 3.0 + (double)w->position.y;
+
+		return sum;
+	}
+};
+
+// nanoseconds per item of running fx() 'reps' times over 'count' items
+template<class FN>
+static double NsPerItem(int reps, size_t count, FN fx)
+{
+	fx();
+
+	long long start = Time::ticks();
+
+	for(int r = 0; r < reps; ++r)
+		fx();
+
+	return Seconds(Time::ticks() - start) * 1e9 / ((double)reps * (double)count);
+}
+
+PQBenchmark::PQBenchmark()
+{
+	_enabled = false;
+	_frames = 1200;
+	_spawn = 1;
+	_threads = 0;
+	_seed = 1;
+	_output = "benchmark.json";
+}
+
+bool PQBenchmark::Configure(const string &commandLine)
+{
+	istringstream args(commandLine);
+	string arg;
+
+	while(args >> arg)
+	{
+		if(arg == "-benchmark")
+		{
+			that->_enabled = true;
+		}
+		else if(arg == "-benchmark-maps")
+		{
+			string list;
+			args >> list;
+			SplitList(list, that->_maps);
+		}
+		else if(arg == "-benchmark-suites")
+		{
+			string list;
+			args >> list;
+			SplitList(list, that->_suites);
+		}
+		else if(arg == "-benchmark-frames")
+		{
+			args >> that->_frames;
+		}
+		else if(arg == "-benchmark-spawn")
+		{
+			args >> that->_spawn;
+		}
+		else if(arg == "-benchmark-threads")
+		{
+			args >> that->_threads;
+		}
+		else if(arg == "-benchmark-seed")
+		{
+			args >> that->_seed;
+		}
+		else if(arg == "-benchmark-out")
+		{
+			args >> that->_output;
+		}
+	}
+
+	return that->_enabled;
+}
+
+bool PQBenchmark::enabled()
+{
+	return that->_enabled;
+}
+
+void PQBenchmark::Run()
+{
+	// the game's clock follows the frames, not the time they took
+	if(Time::fixedStep() == 0)
+		Time::SetFixedStep(1.0f / 60.0f);
+
+	Engine::RunCoroutine([](yield_token<float> yield){ that->_run(yield); });
+}
+
+void PQBenchmark::_run(yield_token<float> yield)
+{
+	char line[160];
+	snprintf(line, sizeof(line), "{\"frames\":%d,\"step\":%.6f,\"spawn\":%d,\"seed\":%llu,\"suites\":{",
+			 _frames, Time::fixedStep(), _spawn, (unsigned long long)_seed);
+	_json = line;
+
+	struct Suite
+	{
+		const char *name;
+		string (PQBenchmark::*run)(yield_token<float> yield);
+	};
+
+	const Suite suites[] =
+	{
+		{ "math", &PQBenchmark::_suiteMath },
+		{ "png", &PQBenchmark::_suitePng },
+		{ "mixer", &PQBenchmark::_suiteMixer },
+		{ "mp3", &PQBenchmark::_suiteMp3 },
+		{ "contexts", &PQBenchmark::_suiteContexts },
+	};
+
+	bool first = true;
+
+	for(auto &suite : suites)
+	{
+		if(!_suiteSelected(suite.name))
+			continue;
+
+		Log(LogLevel::Info, LogCategory::General, "Benchmarking suite", suite.name);
+
+		_json += first ? "\n" : ",\n";
+		_json += JsonString(suite.name) + ":" + (this->*suite.run)(yield);
+		first = false;
+
+		yield(0);
+	}
+
+	_json += "},\"scenarios\":[\n";
+	first = true;
+
+	for(size_t level = 0; level < PlayerProfile::levelCount(); ++level)
+	{
+		const string &map = PlayerProfile::GetLevelData(level).mapFilename;
+		bool selected = _maps.empty() && _suites.empty();
+
+		for(auto &name : _maps)
+			selected |= map.find(name) != string::npos;
+
+		if(!selected)
+			continue;
+
+		if(!first)
+			_json += ",\n";
+
+		first = false;
+
+		_runScenario(level, yield);
+	}
+
+	_json += "\n]}\n";
+
+	bytestream output;
+	output.write(_json.data(), _json.size());
+
+	if(bytestream_to_file(_output, output))
+		Log(LogLevel::Info, LogCategory::General, "Wrote benchmark results", _output);
+	else
+		Log(LogLevel::Error, LogCategory::General, "Couldn't write benchmark results", _output);
+
+	Engine::QuitGame();
+}
+
+bool PQBenchmark::_suiteSelected(const char *name) const
+{
+	return find(_suites.begin(), _suites.end(), name) != _suites.end();
+}
+
+string PQBenchmark::_suiteMath(yield_token<float> yield)
+{
+	const size_t Count = 4096;
+	const int Reps = 1000;
+
+	Rng rng(_seed);
+	vector<vec2f> points(Count);
+	vector<vec2f> out(Count);
+	vector<float> distances(Count);
+
+	for(auto &p : points)
+		p = vec2f(rng.range(-1000.0f, 1000.0f), rng.range(-1000.0f, 1000.0f));
+
+	mat3f rotation(true);
+	rotation.SetRotation(0.3f);
+	mat3f mtx = mat3f::Translation(12.5f, -3.0f) * rotation;
+	vec2f from(17.0f, 42.0f);
+
+	double transformScalar = NsPerItem(Reps, Count, [&]{
+		for(size_t i = 0; i < Count; ++i)
+			out[i] = vec2f(mtx, points[i]);
+		Sink = out[Count - 1].x;
+	});
+
+	double transformBatch = NsPerItem(Reps, Count, [&]{
+		math::TransformPoints(mtx, points.data(), out.data(), Count);
+		Sink = out[Count - 1].x;
+	});
+
+	double distanceScalar = NsPerItem(Reps, Count, [&]{
+		for(size_t i = 0; i < Count; ++i)
+			distances[i] = from.Distance(points[i]);
+		Sink = distances[Count - 1];
+	});
+
+	double distanceBatch = NsPerItem(Reps, Count, [&]{
+		math::Distances(from, points.data(), distances.data(), Count);
+		Sink = distances[Count - 1];
+	});
+
+	double normalize = NsPerItem(Reps, Count, [&]{
+		for(size_t i = 0; i < Count; ++i)
+			out[i] = points[i].Normalized();
+		Sink = out[Count - 1].x;
+	});
+
+	double length = NsPerItem(Reps, Count, [&]{
+		float sum = 0;
+		for(size_t i = 0; i < Count; ++i)
+			sum += points[i].Length();
+		Sink = sum;
+	});
+
+	char json[512];
+	snprintf(json, sizeof(json),
+			 "{\"points\":%d,\"transform_ns\":%.3f,\"transform_batch_ns\":%.3f,"
+			 "\"distance_ns\":%.3f,\"distance_batch_ns\":%.3f,"
+			 "\"normalize_ns\":%.3f,\"length_ns\":%.3f}",
+			 (int)Count, transformScalar, transformBatch, distanceScalar, distanceBatch,
+			 normalize, length);
+
+	return json;
+}
+
+string PQBenchmark::_suitePng(yield_token<float> yield)
+{
+	struct Image
+	{
+		bytestream data;
+		unsigned int width;
+		unsigned int height;
+	};
+
+	vector<string> files;
+	FindFiles("assets\\Images", "png", files);
+
+	vector<Image> images;
+	double compressedBytes = 0;
+	double decodedBytes = 0;
+
+	for(auto &file : files)
+	{
+		Image image;
+		image.data = bytestream_from_file(file);
+
+		if(image.data.empty()
+		|| !NPng::ReadSize((const unsigned char*)image.data.data(), image.data.size(), image.width, image.height))
+		{
+			Log(LogLevel::Warning, LogCategory::Resources, "Benchmark skipped image", file);
+			continue;
+		}
+
+		compressedBytes += (double)image.data.size();
+		decodedBytes += (double)image.width * image.height * 4;
+		images.push_back(move(image));
+	}
+
+	const double MB = 1024.0 * 1024.0;
+	char json[256];
+
+	snprintf(json, sizeof(json), "{\"images\":%d,\"compressed_mb\":%.2f,\"decoded_mb\":%.2f,\"runs\":[",
+			 (int)images.size(), compressedBytes / MB, decodedBytes / MB);
+	string result = json;
+
+	vector<int> counts = ThreadCounts(_threads);
+
+	for(size_t c = 0; c < counts.size(); ++c)
+	{
+		atomic<size_t> next(0);
+		atomic<int> failed(0);
+		long long start = Time::ticks();
+
+		// one job per thread, each takes the next image until none are left
+		{
+			JobGroup decoding;
+
+			for(int t = 0; t < counts[c]; ++t)
+			{
+				decoding.Run([&]{
+					vector<unsigned char> pixels;
+
+					for(size_t i = next++; i < images.size(); i = next++)
+					{
+						Image &image = images[i];
+						pixels.resize((size_t)image.width * image.height * 4);
+
+						if(!NPng::Decode(NPngContext::thread(), (const unsigned char*)image.data.data(),
+										 image.data.size(), pixels.data(), image.width, image.height))
+							++failed;
+					}
+				});
+			}
+
+			decoding.Wait();
+		}
+
+		double seconds = Seconds(Time::ticks() - start);
+
+		snprintf(json, sizeof(json),
+				 "%s{\"threads\":%d,\"seconds\":%.3f,\"decoded_mb_per_s\":%.1f,"
+				 "\"compressed_mb_per_s\":%.1f,\"failed\":%d}",
+				 c ? "," : "", counts[c], seconds, decodedBytes / MB / seconds,
+				 compressedBytes / MB / seconds, failed.load());
+		result += json;
+	}
+
+	return result + "]}";
+}
+
+string PQBenchmark::_suiteMixer(yield_token<float> yield)
+{
+	// the mix is only timed when OpenAL renders into LoopbackOutput
+	if(Audio::output() == AudioOutput::Device)
+		return "{\"skipped\":\"needs the null or wave audio output\"}";
+
+	const char *file = "assets\\Sounds\\Effects\\carIdle.wav";
+	const int counts[] = { 1, 2, 4, 8, 16 };
+	const double Window = 1.0;
+
+	string result = "{\"sound\":" + JsonString(file) + ",\"runs\":[";
+	char json[256];
+
+	for(size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+	{
+		vector<shared_ptr<Sound>> sounds;
+
+		for(int i = 0; i < counts[c]; ++i)
+		{
+			auto sound = make_shared<Sound>(file);
+			sound->SetLoop(true);
+			sound->Play();
+			sounds.push_back(sound);
+		}
+
+		// mixing is paced in real time, measure a window of it
+		yield(0);
+		Audio::ResetMixStats();
+
+		long long start = Time::ticks();
+
+		while(Seconds(Time::ticks() - start) < Window)
+			yield(0);
+
+		MixStats stats = Audio::mixStats();
+		sounds.clear();
+
+		snprintf(json, sizeof(json),
+				 "%s{\"voices\":%d,\"blocks\":%llu,\"us_per_block\":%.2f,"
+				 "\"us_per_voice_block\":%.3f,\"peak_block_us\":%.2f}",
+				 c ? "," : "", counts[c], (unsigned long long)stats.blocks,
+				 stats.secondsPerBlock() * 1e6, stats.secondsPerVoiceBlock() * 1e6,
+				 stats.peakBlockSeconds * 1e6);
+		result += json;
+	}
+
+	return result + "]}";
+}
+
+string PQBenchmark::_suiteMp3(yield_token<float> yield)
+{
+	vector<string> files;
+	FindFiles("assets\\Sounds\\Music", "mp3", files);
+
+	const int BufferSize = 8192;
+	vector<short> shorts(BufferSize);
+	vector<float> floats(BufferSize);
+
+	const double MB = 1024.0 * 1024.0;
+	string result = "{\"tracks\":[";
+	char json[512];
+	bool first = true;
+
+	for(auto &file : files)
+	{
+		MP3Decoder decoder;
+
+		if(!decoder.Open(file.c_str()))
+			continue;
+
+		double fileBytes = (double)ifstream(file, ios::binary | ios::ate).tellg();
+		double samplesPerSecond = (double)decoder.SampleRate() * decoder.Channels();
+
+		// whole track to 16-bit, then again to float
+		uint64_t samples = 0;
+		long long start = Time::ticks();
+
+		int count;
+
+		while((count = decoder.GetSamples(shorts.data(), BufferSize)) > 0)
+			samples += count;
+
+		double shortSeconds = Seconds(Time::ticks() - start);
+
+		decoder.Rewind();
+		start = Time::ticks();
+
+		while(decoder.GetSamples(floats.data(), BufferSize) > 0)
+			continue;
+
+		double floatSeconds = Seconds(Time::ticks() - start);
+		double audioSeconds = (double)samples / samplesPerSecond;
+
+		snprintf(json, sizeof(json),
+				 "%s{\"file\":%s,\"audio_seconds\":%.1f,"
+				 "\"short_seconds\":%.3f,\"short_realtime\":%.1f,\"short_mb_per_s\":%.2f,"
+				 "\"float_seconds\":%.3f,\"float_realtime\":%.1f}",
+				 first ? "" : ",", JsonString(file).c_str(), audioSeconds,
+				 shortSeconds, audioSeconds / shortSeconds, fileBytes / MB / shortSeconds,
+				 floatSeconds, audioSeconds / floatSeconds);
+		result += json;
+		first = false;
+
+		// a frame between tracks keeps the window responsive
+		yield(0);
+	}
+
+	return result + "]}";
+}
+
+string PQBenchmark::_suiteContexts(yield_token<float> yield)
+{
+	const int Frames = 600;
+	int most = ThreadCounts(_threads).back();
+
+	string result = "{\"frames\":" + to_string(Frames) + ",\"runs\":[";
+	char json[256];
+	double reference = 0;
+
+	for(int count = 1; ; count = min(count * 2, most))
+	{
+		vector<double> checksums(count);
+		vector<thread> threads;
+
+		long long start = Time::ticks();
+
+		// each game gets its own context on its own thread, seeded alike
+		for(int i = 0; i < count; ++i)
+		{
+			threads.emplace_back([this, i, &checksums]{
+				EngineContext context;
+				EngineContext::Scope scope(&context);
+
+				Random::Seed(_seed);
+				Time::SetFixedStep(1.0f / 60.0f);
+
+				auto state = make_shared<WalkerState>();
+				Engine::SetState(state);
+
+				for(int f = 0; f < Frames && Engine::Simulate(); ++f){}
+
+				checksums[i] = state->checksum();
+			});
+		}
+
+		for(auto &t : threads)
+			t.join();
+
+		double ms = Seconds(Time::ticks() - start) * 1000.0;
+
+		if(count == 1)
+			reference = checksums[0];
+
+		bool identical = true;
+
+		for(double sum : checksums)
+			identical &= sum == reference;
+
+		snprintf(json, sizeof(json), "%s{\"contexts\":%d,\"ms\":%.2f,\"identical\":%s}",
+				 count == 1 ? "" : ",", count, ms, identical ? "true" : "false");
+		result += json;
+
+		if(!identical)
+			Log(LogLevel::Error, LogCategory::General, "Contexts seeded alike diverged", count);
+
+		yield(0);
+
+		if(count == most)
+			break;
+	}
+
+	return result + "]}";
+}
+
+void PQBenchmark::_runScenario(size_t level, yield_token<float> yield)
+{
+	const string map = PlayerProfile::GetLevelData(level).mapFilename;
+	Log(LogLevel::Info, LogCategory::General, "Benchmarking", map);
+
+	PlayerProfile::SetCurrentLevel(level);
+	Random::Seed(_seed);
+
+	double msPerTick = 1000.0 / (double)Time::frequency();
+	uint64_t loadAllocations = Memory::allocations();
+	long long loadStart = Time::ticks();
+
+	// same path as starting the level from the menu
+	shared_ptr<State> loader = make_shared<PQGameLoader>();
+	Engine::SetState(loader);
+
+	while(Engine::GetState() != loader)
+		yield(0);
+
+	while(Engine::GetState() == loader)
+		yield(0);
+
+	double loadMs = (double)(Time::ticks() - loadStart) * msPerTick;
+	loadAllocations = Memory::allocations() - loadAllocations;
+	loader.reset();
+
+	auto game = Engine::GetState<PQGame>();
+	game->SpawnCopies(_spawn);
+
+	// let the copies start, then drop the frame the profiler was enabled in
+	yield(0);
+	Profiler::Enable(true);
+	yield(0);
+
+	vector<Profiler::Zone> zones;
+	Profiler::Collect(zones);
+
+	vector<Phase> phases;
+	uint32_t threadID = GetCurrentThreadId();
+	uint64_t allocations = Memory::allocations();
+	int step = -1;
+	int stepEnd = 0;
+	int frame = 0;
+
+	for( ; frame < _frames && game->gameRunning; ++frame)
+	{
+		// keys go through the engine's input path, like the player's would
+		if(frame == stepEnd)
+		{
+			if(step >= 0)
+				Engine::OnKeyUp(Script[step].key);
+
+			step = (step + 1) % ScriptLength;
+			Engine::OnKeyDown(Script[step].key);
+			stepEnd = frame + Script[step].frames;
+		}
+
+		yield(0);
+
+		zones.clear();
+		Profiler::Collect(zones);
+		_addFrame(phases, zones, threadID);
+	}
+
+	if(step >= 0)
+		Engine::OnKeyUp(Script[step].key);
+
+	Profiler::Enable(false);
+	allocations = Memory::allocations() - allocations;
+
+	const double MB = 1024.0 * 1024.0;
+	char line[512];
+
+	snprintf(line, sizeof(line),
+			 "{\"map\":%s,\"load_ms\":%.2f,\"pedestrians\":%d,\"cars\":%d,\"frames\":%d,"
+			 "\"working_set_mb\":%.1f,\"peak_working_set_mb\":%.1f,",
+			 JsonString(map).c_str(), loadMs,
+			 (int)game->characters.size(), (int)game->npcCars.size(), frame,
+			 (double)Memory::workingSet() / MB, (double)Memory::peakWorkingSet() / MB);
+	_json += line;
+
+	// only builds with PQ_COUNT_ALLOCATIONS=1 count them
+	if(Memory::countingAllocations())
+	{
+		snprintf(line, sizeof(line),
+				 "\"load_allocations\":%llu,\"allocations\":%llu,\"allocations_per_frame\":%.1f,",
+				 (unsigned long long)loadAllocations, (unsigned long long)allocations,
+				 frame ? (double)allocations / (double)frame : 0.0);
+		_json += line;
+	}
+
+	_json += "\"zones\":{";
+
+	for(size_t i = 0; i < phases.size(); ++i)
+	{
+		auto &ms = phases[i].ms;
+		sort(ms.begin(), ms.end());
+
+		double sum = 0;
+
+		for(float sample : ms)
+			sum += sample;
+
+		snprintf(line, sizeof(line),
+				 "%s\"%s\":{\"mean\":%.3f,\"p50\":%.3f,\"p95\":%.3f,\"p99\":%.3f,\"max\":%.3f}",
+				 i ? "," : "", phases[i].name.c_str(), sum / (double)ms.size(),
+				 Percentile(ms, 0.50f), Percentile(ms, 0.95f), Percentile(ms, 0.99f), ms.back());
+		_json += line;
+	}
+
+	_json += "}}";
+}
+
+void PQBenchmark::_addFrame(vector<Phase> &phases, const vector<Profiler::Zone> &zones, uint32_t threadID)
+{
+	double msPerTick = 1000.0 / (double)Time::frequency();
+	vector<double> totals(phases.size(), 0.0);
+	vector<bool> ran(phases.size(), false);
+
+	// zones that run more than once a frame, like RenderQueue::Execute, are summed
+	for(auto &zone : zones)
+	{
+		if(zone.threadID != threadID)
+			continue;
+
+		size_t i = 0;
+
+		while(i < phases.size() && phases[i].name != zone.name)
+			++i;
+
+		if(i == phases.size())
+		{
+			phases.push_back(Phase());
+			phases.back().name = zone.name;
+			totals.push_back(0.0);
+			ran.push_back(false);
+		}
+
+		totals[i] += (double)(zone.end - zone.begin) * msPerTick;
+		ran[i] = true;
+	}
+
+	for(size_t i = 0; i < phases.size(); ++i)
+	{
+		if(ran[i])
+			phases[i].ms.push_back((float)totals[i]);
+	}
+}
@@ -0,0 +1,66 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Singleton.h"
+#include "Profiler.h"
+#include <coroutine.h>
+using namespace coroutines;
+using namespace std;
+
+// Loads every map through the regular loading screen, or only the maps picked
+// on the command line, and plays each one for a fixed number of frames with
+// scripted input. Load time, per zone frame time percentiles, the working set
+// and, in builds that count them, allocations are written as JSON, then the
+// game quits. Frames advance by a fixed step, 1/60 s unless -fixed-fps gives
+// another, so runs can be compared frame for frame.
+//
+// Suites are microbenchmarks of single systems that run before the maps.
+// When suites are picked the maps only run if they're picked too.
+class PQBenchmark : public Singleton<PQBenchmark>
+{
+public:
+	PQBenchmark();
+
+	// handles "-benchmark", "-benchmark-maps Map01,Map04", "-benchmark-frames N",
+	// "-benchmark-spawn K", "-benchmark-seed S", "-benchmark-out <file>",
+	// "-benchmark-suites math,png,mixer,mp3,contexts" and "-benchmark-threads N"
+	// anywhere on the command line. Returns true if -benchmark was given.
+	static bool Configure(const string &commandLine);
+	static bool enabled();
+
+	// called instead of showing the menu, once the player's levels are known
+	static void Run();
+
+private:
+	struct Phase
+	{
+		string name;
+		vector<float> ms; // one sample per frame the zone ran in
+	};
+
+	bool _enabled;
+	vector<string> _maps;
+	vector<string> _suites;
+	int _frames;
+	int _spawn;
+	int _threads; // most threads the suites use, 0 for the whole pool
+	uint64_t _seed;
+	string _output;
+	string _json;
+
+	void _run(yield_token<float> yield);
+	bool _suiteSelected(const char *name) const;
+	string _suiteMath(yield_token<float> yield);
+	string _suitePng(yield_token<float> yield);
+	string _suiteMixer(yield_token<float> yield);
+	string _suiteMp3(yield_token<float> yield);
+	string _suiteContexts(yield_token<float> yield);
+	void _runScenario(size_t level, yield_token<float> yield);
+	static void _addFrame(vector<Phase> &phases, const vector<Profiler::Zone> &zones, uint32_t threadID);
+};
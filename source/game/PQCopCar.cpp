@@ -31,11 +31,10 @@ void PQCopCar::Start()
 
 	img->layer = DrawLayer::Cars;
 
-	body = make_shared<RigidBody>(state()->physics,
-								  GetResource()->collision_shapes,
+	body = New<RigidBody>(state()->physics,
+								  GetResource()->b2Shapes(scale),
 								  position,
-								  math::rad(angle),
-								  scale);
+								  math::rad(angle));
 
 	body->type(RigidBody::Type::Kinematic);
 	body->self_mask(ContactMask::Car);
@@ -80,8 +79,8 @@ void PQCopCar::LateUpdate()
 
 	vec2f pos = Physics::toMeters(position + rightOffset);
 	
-	body->position(pos);
-	body->transform(pos, currentAngle);
+	float ang = currentAngle;
+	Defer([this, pos, ang]{ body->transform(pos, ang); });
 	
 	float degAngle = math::mod(-math::deg(currentAngle), 360.0f);
 
@@ -34,6 +34,7 @@ public:
 	virtual ~PQCopCar();
 	
 	virtual void LateUpdate();
+	virtual UpdatePhase threadSafePhases() const override { return UpdatePhase::LateUpdate; }
 	virtual string tag() const override { return "Car"; }
 
 	virtual void Start() override;
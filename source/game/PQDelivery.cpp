@@ -10,7 +10,7 @@ using namespace coroutines;
 
 PQDelivery::PQDelivery()
 {
-	
+	uTintID = -1;
 }
 
 PQDelivery::~PQDelivery()
@@ -22,6 +22,7 @@ void PQDelivery::Start()
 {
 	shader = make_shared<Shader>("assets\\Shaders\\default.vert", "assets\\Shaders\\tinted.frag");
 	AddChild(shader);
+	uTintID = shader->GetUniformID("uTint");
 
 	img->layer = DrawLayer::Tiles + 100;
 	img->SetPos(position.x, position.y);
@@ -29,7 +30,7 @@ void PQDelivery::Start()
 	img->SetShader(shader);
 	img->SetStatic(true);
 
-	body = make_shared<RigidBody>(state()->physics,
+	body = New<RigidBody>(state()->physics,
 								  Physics::toMeters(position),
 								  angle,
 								  RigidBody::Type::Trigger);
@@ -51,7 +52,7 @@ void PQDelivery::LateUpdate()
 		float s = sin(Time::time() * 6);
 		float c = ((s + 1.0f) * 0.5f) * 0.7f + 0.3f;
 		shader->SetActive();
-		shader->SetUniform("uTint", Color(c, c, c));
+		shader->SetUniform(uTintID, Color(c, c, c));
 	}
 }
 
@@ -17,6 +17,7 @@
 class PQDelivery : public PQMapImage
 {
 	shared_ptr<Shader> shader;
+	int uTintID;
 public:
 	PQDelivery();
 	~PQDelivery();
@@ -4,6 +4,7 @@
 *--------------------------------------------------------------------------------------------*/
 
 #include "PQGame.h"
+#include "Log.h"
 #include "PQPauseMenu.h"
 #include "PQScoreScreen.h"
 #include "PQCredits.h"
@@ -13,6 +14,9 @@
 #include "curves.h"
 #include "Math.h"
 #include "PlayerProfile.h"
+#include "Profiler.h"
+#include "TextureFile.h"
+#include "ThreadPool.h"
 #include <algorithm>
 using namespace std;
 
@@ -36,7 +40,10 @@ PQGame::PQGame()
 	showingHelp = false;
 	cameraScaleVelocity = 0;
 
-	srand((unsigned int)time(nullptr));
+	// released by the Engine when the level is removed, see Arena::Release
+	arena = make_shared<Arena>();
+
+	rng = Random::NewStream();
 }
 
 PQGame::~PQGame()
@@ -95,6 +102,23 @@ void PQGame::OnKeyUp(KeyCode keyCode)
 	case KeyCode::E:
 		if(gameRunning) player->ToggleInCar();
 		break;
+	case KeyCode::F:
+		// toggles a profiler capture, which is written out when it stops
+		if(Profiler::enabled())
+		{
+			Profiler::Enable(false);
+
+			if(Profiler::ExportChromeTrace("profile.json"))
+				Trace("Wrote profiler capture", string("profile.json"));
+		}
+		else
+		{
+			if(!frameGraph)
+				frameGraph.reset(new FrameGraph());
+
+			Profiler::Enable(true);
+		}
+		break;
 	case KeyCode::Space:
 
 		break;
@@ -170,6 +194,7 @@ void PQGame::Initialize(yield_token<float> yield)
 		phoneRing = AddChild(make_shared<Sound>());
 		phoneRing->Open("assets\\Sounds\\Effects\\phonering.wav");
 		phoneRing->SetGain(0.2f);
+		phoneRing->SetCategory(SoundCategory::Speech);
 	});
 
 	loaderTasks.emplace_back([this]{
@@ -187,31 +212,37 @@ void PQGame::Initialize(yield_token<float> yield)
 	loaderTasks.emplace_back([this]{
 		customers.emplace_back(AddChild(make_shared<Sound>()));
 		customers.back()->Open("assets\\Sounds\\Effects\\customer01.wav");
+		customers.back()->SetCategory(SoundCategory::Speech);
 	});
 
 	loaderTasks.emplace_back([this]{
 		customers.emplace_back(AddChild(make_shared<Sound>()));
 		customers.back()->Open("assets\\Sounds\\Effects\\customer02.wav");
+		customers.back()->SetCategory(SoundCategory::Speech);
 	});
 
 	loaderTasks.emplace_back([this]{
 		customers.emplace_back(AddChild(make_shared<Sound>()));
 		customers.back()->Open("assets\\Sounds\\Effects\\customer03.wav");
+		customers.back()->SetCategory(SoundCategory::Speech);
 	});
 
 	loaderTasks.emplace_back([this]{
 		customers.emplace_back(AddChild(make_shared<Sound>()));
 		customers.back()->Open("assets\\Sounds\\Effects\\customer04.wav");
+		customers.back()->SetCategory(SoundCategory::Speech);
 	});
 
 	loaderTasks.emplace_back([this]{
 		customers.emplace_back(AddChild(make_shared<Sound>()));
 		customers.back()->Open("assets\\Sounds\\Effects\\customer05.wav");
+		customers.back()->SetCategory(SoundCategory::Speech);
 	});
 
 	loaderTasks.emplace_back([this]{
 		customers.emplace_back(AddChild(make_shared<Sound>()));
 		customers.back()->Open("assets\\Sounds\\Effects\\customer06.wav");
+		customers.back()->SetCategory(SoundCategory::Speech);
 	});
 
 	loaderTasks.emplace_back([this]{
@@ -341,6 +372,62 @@ void PQGame::Initialize(yield_token<float> yield)
 	StartGame();
 }
 
+void PQGame::CreateSprite(PQMapImage *mapImg)
+{
+	mapImg->img = mapImg->AddChild(New<Sprite>());
+	mapImg->img->category = 1;
+	mapImg->img->SetTexture(mapImg->GetResource()->tex);
+	mapImg->img->SetNumRows(mapImg->GetResource()->nRows);
+	mapImg->img->SetNumCols(mapImg->GetResource()->nCols);
+	mapImg->img->SetPos(mapImg->position);
+	mapImg->img->SetAngle(mapImg->angle);
+	mapImg->img->SetScale(mapImg->scale);
+	mapImg->img->SetRow(mapImg->row);
+	mapImg->img->SetColumn(mapImg->col);
+}
+
+static void CopyMapImage(const PQMapImage &from, PQMapImage &to, const Graph &graph, Rng &rng)
+{
+	to.resource = from.resource;
+	to.type = from.type;
+	to.angle = from.angle;
+	to.scale = from.scale;
+	to.row = from.row;
+	to.col = from.col;
+	to.value1 = from.value1;
+	to.value2 = from.value2;
+	to.resIndex = from.resIndex;
+
+	// stacking copies on the original would just push them apart
+	to.position = graph.nodes.empty() ? from.position
+				: graph.nodes[rng.index((uint32_t)graph.nodes.size())]->pos;
+}
+
+void PQGame::SpawnCopies(int multiple)
+{
+	size_t nCharacters = characters.size();
+	size_t nCars = npcCars.size();
+
+	for(int m = 1; m < multiple; ++m)
+	{
+		for(size_t i = 0; i < nCharacters; ++i)
+		{
+			auto pedestrian = AddChild(New<PQPedestrian>(this));
+			CopyMapImage(*characters[i], *pedestrian, pedGraph, rng);
+			CreateSprite(pedestrian.get());
+			characters.push_back(pedestrian);
+		}
+
+		for(size_t i = 0; i < nCars; ++i)
+		{
+			auto car = AddChild(New<PQCopCar>(this));
+			CopyMapImage(*npcCars[i], *car, vehGraph, rng);
+			CreateSprite(car.get());
+			npcCars.push_back(car);
+		}
+	}
+}
+
 void PQGame::StartGame()
 {
 	deliveryStatus->deliveryCount(numDeliveries);
@@ -448,7 +535,7 @@ void PQGame::DoPickup()
 		phoneRing->Play();
 		yield(phoneRing->length() * 0.8f);
 
-		auto& snd = customers[rand() % customers.size()];
+		auto& snd = customers[rng.index((uint32_t)customers.size())];
 		snd->Play();
 
 		yield(snd->length());
@@ -746,7 +833,7 @@ void PQGame::StateDraw()
 	
 	RenderQueue::Clear();
 	
-	SubmitDrawCalls_R(mainMask);
+	registry.SubmitDrawCalls(mainMask, mainCamera->viewRect);
 
 	RenderQueue::Sort();
 	RenderQueue::Execute();
@@ -756,10 +843,13 @@ void PQGame::StateDraw()
 
 	RenderQueue::Clear();
 	
-	SubmitDrawCalls_R(guiMask);
+	registry.SubmitDrawCalls(guiMask, guiCamera->viewRect);
 	
 	RenderQueue::Sort();
 	RenderQueue::Execute();
+
+	if(frameGraph && Profiler::enabled())
+		frameGraph->Draw();
 }
 
 void PQGame::OnTouchDown(float x, float y, int id)
@@ -808,7 +898,7 @@ int PQGame::OpenMap(const char *filename, yield_token<float> yield, int loadTask
 
 	if(mapfile.empty())
 	{
-		Trace("Could not open map file", filename);
+		Log(LogLevel::Error, LogCategory::Resources, "Could not open map file", filename);
 		return -1;
 	}
 	
@@ -873,6 +963,8 @@ int PQGame::OpenMap(const char *filename, yield_token<float> yield, int loadTask
 	float progressPerResource = 1.0f / (loadTaskCount + nResources + (nObjects / 10));
 	float progressPerObject = progressPerResource / 10.0f;
 
+	vector<PQResImage*> images;
+
 	for(int i = 0; i < nResources; i++)
 	{
 		uint8_t type;
@@ -882,7 +974,7 @@ int PQGame::OpenMap(const char *filename, yield_token<float> yield, int loadTask
 		{
 			case RES_IMAGE:
 			{
-				shared_ptr<PQResImage> rImg = make_shared<PQResImage>();
+				shared_ptr<PQResImage> rImg = make_pooled<PQResImage>(arena);
 				
 				rImg->type = type;
 				
@@ -896,7 +988,7 @@ int PQGame::OpenMap(const char *filename, yield_token<float> yield, int loadTask
 				mapfile.read((char*)&rImg->nRows, sizeof(uint16_t));
 				mapfile.read((char*)&rImg->nCols, sizeof(uint16_t));
 
-				rImg->Init();
+				images.push_back(rImg.get());
 
 				int nShapes;
 				mapfile.read((char*)&nShapes, sizeof(int));
@@ -910,7 +1002,7 @@ int PQGame::OpenMap(const char *filename, yield_token<float> yield, int loadTask
 					{
 						case SHAPE_CIRCLE:
 						{
-							auto circle = make_shared<PQB2Circle>();
+							auto circle = make_pooled<PQB2Circle>(arena);
 							mapfile.read((char*)&circle->center, sizeof(vec2f));
 							mapfile.read((char*)&circle->radius, sizeof(float));
 							rImg->collision_shapes.push_back(circle);
@@ -918,7 +1010,7 @@ int PQGame::OpenMap(const char *filename, yield_token<float> yield, int loadTask
 						}
 						case SHAPE_POLYGON:
 						{
-							auto polygon = make_shared<PQB2Polygon>();
+							auto polygon = make_pooled<PQB2Polygon>(arena);
 							mapfile.read((char*)&polygon->nVerts, sizeof(int));
 							mapfile.read((char*)polygon->vertices, polygon->nVerts * sizeof(vec2f));
 							rImg->collision_shapes.push_back(polygon);
@@ -926,7 +1018,7 @@ int PQGame::OpenMap(const char *filename, yield_token<float> yield, int loadTask
 						}
 						case SHAPE_BOX:
 						{
-							auto box = make_shared<PQB2Box>();
+							auto box = make_pooled<PQB2Box>(arena);
 							mapfile.read((char*)&box->center, sizeof(vec2f));
 							mapfile.read((char*)&box->halfWidth, sizeof(float));
 							mapfile.read((char*)&box->halfHeight, sizeof(float));
@@ -936,7 +1028,7 @@ int PQGame::OpenMap(const char *filename, yield_token<float> yield, int loadTask
 						}
 						case SHAPE_EDGE:
 						{
-							auto edge = make_shared<PQB2Edge>();
+							auto edge = make_pooled<PQB2Edge>(arena);
 							mapfile.read((char*)&edge->p1, sizeof(vec2f));
 							mapfile.read((char*)&edge->p2, sizeof(vec2f));
 							rImg->collision_shapes.push_back(edge);
@@ -951,7 +1043,7 @@ int PQGame::OpenMap(const char *filename, yield_token<float> yield, int loadTask
 			}
 			case RES_SOUND:
 			{
-				shared_ptr<PQResSound> rSnd = make_shared<PQResSound>();
+				shared_ptr<PQResSound> rSnd = make_pooled<PQResSound>(arena);
 
 				mapfile.read((char*)&rSnd->source_file, sizeof(rSnd->source_file));
 				mapfile.read((char*)&rSnd->resource_name, sizeof(rSnd->resource_name));
@@ -969,8 +1061,62 @@ int PQGame::OpenMap(const char *filename, yield_token<float> yield, int loadTask
 			}
 		}
 
-		progress += progressPerResource;
-		TryYield(yield);
+		// images are counted once they're uploaded
+		if(type != RES_IMAGE)
+		{
+			progress += progressPerResource;
+			TryYield(yield);
+		}
+	}
+
+	// decode the images on the pool a batch at a time, the GL uploads have to
+	// stay on this thread. The next batch decodes while this one uploads, and
+	// batches keep the decoded pixels from piling up.
+	size_t batchSize = (size_t)(ThreadPool::workerCount() + 1) * 2;
+	vector<TextureFile> decoded[2] = { vector<TextureFile>(batchSize), vector<TextureFile>(batchSize) };
+	JobGroup decoding;
+
+	auto decodeBatch = [&](size_t first)
+	{
+		size_t count = min(batchSize, images.size() - first);
+		PQResImage **batch = &images[first];
+		TextureFile *files = decoded[(first / batchSize) % 2].data();
+
+		decoding.ParallelFor(count, 1, [batch, files](size_t begin, size_t end){
+			for(size_t j = begin; j < end; ++j)
+			{
+				PROFILE_ZONE("Texture::Decode");
+				Texture::Decode(batch[j]->source_file, files[j]);
+			}
+		});
+	};
+
+	if(!images.empty())
+		decodeBatch(0);
+
+	for(size_t first = 0; first < images.size(); first += batchSize)
+	{
+		size_t count = min(batchSize, images.size() - first);
+		PQResImage **batch = &images[first];
+		TextureFile *files = decoded[(first / batchSize) % 2].data();
+
+		// keeps the loading screen drawing instead of blocking on the pool
+		WaitFor(yield, decoding, progress);
+
+		if(first + batchSize < images.size())
+			decodeBatch(first + batchSize);
+
+		for(size_t j = 0; j < count; ++j)
+		{
+			{
+				PROFILE_ZONE("OpenMap Upload");
+				batch[j]->Init(files[j]);
+				files[j].levels.clear();
+			}
+
+			progress += progressPerResource;
+			TryYield(yield);
+		}
 	}
 
 // MAP OBJECTS
@@ -1011,46 +1157,46 @@ int PQGame::OpenMap(const char *filename, yield_token<float> yield, int loadTask
 
 				if(ClassID == "Tile")
 				{
-					auto tile = AddChild(make_shared<PQTile>());
+					auto tile = AddChild(New<PQTile>());
 					tiles.push_back(tile);
 					mapImg = tile;
 				}
 				else if(ClassID == "Structure")
 				{
-					auto structure = AddChild(make_shared<PQStructure>());
+					auto structure = AddChild(New<PQStructure>());
 					structures.emplace_back(structure);
 					mapImg = structure;
 				}
 				else if(ClassID == "Prop")
 				{
-					auto prop = AddChild(make_shared<PQProp>());
+					auto prop = AddChild(New<PQProp>());
 					props.emplace_back(prop);
 					mapImg = prop;
 				}
 				else if(ClassID == "Delivery")
 				{
-					auto delivery = make_shared<PQDelivery>();
+					auto delivery = New<PQDelivery>();
 					possibleDeliveries.push_back(delivery);
 					mapImg = delivery;
 				}
 				else if(ClassID == "PlayerStart")
 				{
-					player = AddChild(make_shared<PQPlayer>(position));
-					mapImg = make_shared<PQMapImage>(); // dummy
+					player = AddChild(New<PQPlayer>(position));
+					mapImg = New<PQMapImage>(); // dummy
 				}
 				else if(ClassID == "PizzaShop")
 				{
-					pizzaShop = AddChild(make_shared<PQPizzaShop>());
+					pizzaShop = AddChild(New<PQPizzaShop>());
 					mapImg = pizzaShop;
 				}
 				else if(ClassID == "PizzaPickup")
 				{
-					pizzaPickup = AddChild(make_shared<PQPizzaPickup>());
+					pizzaPickup = AddChild(New<PQPizzaPickup>());
 					mapImg = pizzaPickup;
 				}
 				else if(ClassID == "Vehicle")
 				{
-					auto car = AddChild(make_shared<PQVehicle>());
+					auto car = AddChild(New<PQVehicle>());
 					cars.emplace_back(car);
 					mapImg = car;
 				}
@@ -1058,29 +1204,29 @@ int PQGame::OpenMap(const char *filename, yield_token<float> yield, int loadTask
 					 || ClassID == "Pedestrian"
 					 || ClassID == "Chaser")
 				{
-					auto pedestrian = AddChild(make_shared<PQPedestrian>(this));
+					auto pedestrian = AddChild(New<PQPedestrian>(this));
 					characters.push_back(pedestrian);
 					mapImg = pedestrian;
 				}
 				else if(ClassID == "CopCar")
 				{
-					auto car = AddChild(make_shared<PQCopCar>(this));
+					auto car = AddChild(New<PQCopCar>(this));
 					npcCars.push_back(car);
 					mapImg = car;
 				}
 				else if(ClassID == "Health")
 				{
-					auto powerup = AddChild(make_shared<PQPowerUp>(PQPowerUp::Type::Health));
+					auto powerup = AddChild(New<PQPowerUp>(PQPowerUp::Type::Health));
 					mapImg = powerup;
 				}
 				else if(ClassID == "Speed")
 				{
-					auto powerup = AddChild(make_shared<PQPowerUp>(PQPowerUp::Type::Speed));
+					auto powerup = AddChild(New<PQPowerUp>(PQPowerUp::Type::Speed));
 					mapImg = powerup;
 				}
 				else if(ClassID == "Time")
 				{
-					auto powerup = AddChild(make_shared<PQPowerUp>(PQPowerUp::Type::Time));
+					auto powerup = AddChild(New<PQPowerUp>(PQPowerUp::Type::Time));
 					mapImg = powerup;
 				}
 
@@ -1096,16 +1242,7 @@ int PQGame::OpenMap(const char *filename, yield_token<float> yield, int loadTask
 					mapImg->value2 = value2;
 					mapImg->position = position;
 					mapImg->resIndex = resIndex;
-					mapImg->img = mapImg->AddChild(make_shared<Sprite>());
-					mapImg->img->category = 1;
-					mapImg->img->SetTexture(mapImg->GetResource()->tex);
-					mapImg->img->SetNumRows(mapImg->GetResource()->nRows);
-					mapImg->img->SetNumCols(mapImg->GetResource()->nCols);
-					mapImg->img->SetPos(position);
-					mapImg->img->SetAngle(angle);
-					mapImg->img->SetScale(scale);
-					mapImg->img->SetRow(row);
-					mapImg->img->SetColumn(col);
+					CreateSprite(mapImg.get());
 				}
 				else if(ClassID == "PlayerStart")
 				{
@@ -1113,7 +1250,7 @@ int PQGame::OpenMap(const char *filename, yield_token<float> yield, int loadTask
 				}
 				else
 				{
-					Trace("Tried to load unsupport map image: ", ClassID);
+					Log(LogLevel::Warning, LogCategory::Resources, "Tried to load unsupported map image", ClassID);
 				}
 
 				break;
@@ -1144,6 +1281,22 @@ int PQGame::OpenMap(const char *filename, yield_token<float> yield, int loadTask
 		progress += progressPerObject;
 		TryYield(yield);
 	}
+
+// STATIC COLLISION
+	{
+		PROFILE_ZONE("OpenMap StaticCollision");
+
+		staticCollision = AddChild(New<StaticCollision>(physics));
+
+		for(auto &tile : tiles)
+			tile->AddCollision(*staticCollision);
+
+		for(auto &structure : structures)
+			structure->AddCollision(*staticCollision);
+
+		for(auto &prop : props)
+			prop->AddCollision(*staticCollision);
+	}
 	
 // NUMBER OF PEDESTRIAN GRAPH NODES
 	int nPedGraphNodes;
@@ -1214,7 +1367,7 @@ int PQGame::OpenMap(const char *filename, yield_token<float> yield, int loadTask
 
 	for(int i = 0; i < maxDeliveries; i++)
 	{
-		int rDelivery = rand() % possibleDeliveries.size();
+		int rDelivery = rng.index((uint32_t)possibleDeliveries.size());
 		auto it = possibleDeliveries.begin() + rDelivery;
 		
 		auto delivery = AddChild(*it);
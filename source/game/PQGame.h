@@ -18,6 +18,7 @@
 #include "PizzaQuest.h"
 #include "PQStillImage.h"
 #include "PQGameTypes.h"
+#include "Random.h"
 #include "PQDelivery.h"
 #include "PQPizzaPickup.h"
 #include "PQStructure.h"
@@ -37,6 +38,7 @@
 #include "PQHealthBar.h"
 #include "PQDeliveryStatus.h"
 #include "PQStrikeCounter.h"
+#include "FrameGraph.h"
 #include <cstdlib>
 #include <vector>
 #include <algorithm>
@@ -61,6 +63,11 @@ public:
 	void Initialize(yield_token<float> yield);
 	int OpenMap(const char *filename, yield_token<float> yield, int loadTaskCount);
 	void TryYield(yield_token<float> yield);
+	void CreateSprite(PQMapImage *mapImg);
+
+	// adds multiple - 1 copies of every pedestrian and cop car on the map,
+	// each at a random node of its graph
+	void SpawnCopies(int multiple);
 
 ////////////////////////////////////
 
@@ -153,6 +160,8 @@ public:
 	shared_ptr<RigidBody> mapBordersRight;
 	shared_ptr<RigidBody> mapBordersTop;
 	shared_ptr<RigidBody> mapBordersBottom;
+	shared_ptr<StaticCollision> staticCollision;
+	unique_ptr<FrameGraph> frameGraph;
 	vector<shared_ptr<Sprite>> pizzaIcons;
 	shared_ptr<PQPizzaShop> pizzaShop;
 	shared_ptr<PQPizzaPickup> pizzaPickup;
@@ -183,4 +192,5 @@ public:
 	shared_ptr<Texture> msgGoodJob;
 	shared_ptr<Sprite> helperArrow;
 	shared_ptr<Stream> mainSong;
+	Rng rng;
 };
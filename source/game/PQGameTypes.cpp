@@ -4,7 +4,10 @@
 *--------------------------------------------------------------------------------------------*/
 
 #include "PQGameTypes.h"
+#include "Log.h"
 #include "State.h"
+#include <algorithm>
+#include <cmath>
 
 /*****************************
 PQ RESOURCE
@@ -31,10 +34,147 @@ PQResImage::~PQResImage()
 
 void PQResImage::Init()
 {
-	tex = make_shared<Texture>();
+	tex = New<Texture>();
 	tex->Open(source_file);
 }
 
+void PQResImage::Init(const TextureFile &file)
+{
+	tex = New<Texture>();
+
+	if(!tex->Open(file))
+		Log(LogLevel::Error, LogCategory::Resources, "Failed to open image", source_file);
+}
+
+// the Box2D checks only exist in debug builds, a bad shape breaks contacts quietly
+static bool ValidPolygon(b2Vec2 *pts, int count)
+{
+	if(count < 3 || count > b2_maxPolygonVertices)
+		return false;
+
+	float area = 0;
+
+	for(int i = 0; i < count; ++i)
+	{
+		b2Vec2 edge = pts[(i + 1) % count] - pts[i];
+
+		if(edge.LengthSquared() <= b2_epsilon * b2_epsilon)
+			return false;
+
+		area += b2Cross(pts[i], pts[(i + 1) % count]);
+	}
+
+	if(fabs(area) <= b2_epsilon)
+		return false;
+
+	// Box2D wants counter clockwise winding
+	if(area < 0)
+		reverse(pts, pts + count);
+
+	return true;
+}
+
+const vector<shared_ptr<b2Shape>> &PQResImage::b2Shapes(float scale)
+{
+	auto it = _b2Shapes.find(scale);
+
+	if(it != _b2Shapes.end())
+		return it->second;
+
+	auto &shapes = _b2Shapes[scale];
+
+	for(auto &shape : collision_shapes)
+	{
+		switch(shape->type)
+		{
+		case SHAPE_CIRCLE:
+		{
+			auto circle = (PQB2Circle*)shape.get();
+			vec2f center = Physics::toMeters(circle->center) * scale;
+
+			auto b2circle = make_shared<b2CircleShape>();
+			b2circle->m_radius = Physics::toMeters(circle->radius) * scale;
+			b2circle->m_p.Set(center.x, center.y);
+
+			if(b2circle->m_radius > 0)
+				shapes.push_back(b2circle);
+			else
+				Log(LogLevel::Warning, LogCategory::Physics, "invalid collision circle", resource_name);
+
+			break;
+		}
+
+		case SHAPE_POLYGON:
+		{
+			auto polygon = (PQB2Polygon*)shape.get();
+			float s = scale * Physics::meterScaleFactor;
+
+			b2Vec2 pts[b2_maxPolygonVertices];
+			int count = polygon->nVerts;
+
+			for(int i = 0; i < count && i < b2_maxPolygonVertices; ++i)
+				pts[i].Set(polygon->vertices[i].x * s, polygon->vertices[i].y * s);
+
+			if(ValidPolygon(pts, count))
+			{
+				auto b2polygon = make_shared<b2PolygonShape>();
+				b2polygon->Set(pts, count);
+				shapes.push_back(b2polygon);
+			}
+			else
+			{
+				Log(LogLevel::Warning, LogCategory::Physics, "invalid collision polygon", resource_name);
+			}
+
+			break;
+		}
+
+		case SHAPE_BOX:
+		{
+			auto box = (PQB2Box*)shape.get();
+			vec2f center = Physics::toMeters(box->center) * scale;
+			float hw = Physics::toMeters(box->halfWidth) * scale;
+			float hh = Physics::toMeters(box->halfHeight) * scale;
+
+			if(hw > b2_epsilon && hh > b2_epsilon)
+			{
+				auto b2box = make_shared<b2PolygonShape>();
+				b2box->SetAsBox(hw, hh, b2Vec2(center.x, center.y), Physics::toMeters(box->angle));
+				shapes.push_back(b2box);
+			}
+			else
+			{
+				Log(LogLevel::Warning, LogCategory::Physics, "invalid collision box", resource_name);
+			}
+
+			break;
+		}
+
+		case SHAPE_EDGE:
+		{
+			auto edge = (PQB2Edge*)shape.get();
+			vec2f p1 = Physics::toMeters(edge->p1) * scale;
+			vec2f p2 = Physics::toMeters(edge->p2) * scale;
+
+			if((p2 - p1).LengthSq() > b2_epsilon * b2_epsilon)
+			{
+				auto b2edge = make_shared<b2EdgeShape>();
+				b2edge->Set(b2Vec2(p1.x, p1.y), b2Vec2(p2.x, p2.y));
+				shapes.push_back(b2edge);
+			}
+			else
+			{
+				Log(LogLevel::Warning, LogCategory::Physics, "invalid collision edge", resource_name);
+			}
+
+			break;
+		}
+		}
+	}
+
+	return shapes;
+}
+
 /*****************************
 PQ RESOURCE SOUND
 *****************************/
@@ -46,7 +186,7 @@ PQResSound::PQResSound()
 
 void PQResSound::Init()
 {
-	snd = AddChild(make_shared<Sound>());
+	snd = AddChild(New<Sound>());
 	snd->Open(source_file);
 }
 
@@ -93,11 +233,10 @@ shared_ptr<PQResImage> PQMapImage::GetResource()
 
 void PQMapImage::Start()
 {
-	body = make_shared<RigidBody>(state()->physics,
-								  GetResource()->collision_shapes,
+	body = New<RigidBody>(state()->physics,
+								  GetResource()->b2Shapes(scale),
 								  position,
-								  RADIANS(angle),
-								  scale);
+								  RADIANS(angle));
 
 	AddChild(body);
 }
@@ -5,6 +5,7 @@
 
 #pragma once
 #include <vector>
+#include <map>
 #include "Math.h"
 #include "Object.h"
 #include "PQB2Shapes.h"
@@ -60,6 +61,9 @@ public:
 
 	virtual void Init();
 
+	// uploads an image already decoded with Texture::Decode
+	void Init(const TextureFile &file);
+
 	// READ FROM FILE
 	uint16_t nRows;
 	uint16_t nCols;
@@ -67,6 +71,13 @@ public:
 	
 	vector<shared_ptr<PQB2Shape>> collision_shapes;
 	shared_ptr<Texture> tex;
+
+	// collision_shapes as Box2D shapes in meters at 'scale'. They're built and
+	// validated the first time a scale is asked for, fixtures copy them.
+	const vector<shared_ptr<b2Shape>> &b2Shapes(float scale);
+
+private:
+	map<float, vector<shared_ptr<b2Shape>>> _b2Shapes;
 };
 
 /*****************************
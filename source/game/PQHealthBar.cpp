@@ -22,6 +22,10 @@ PQHealthBar::PQHealthBar()
 	_fill = 0;
 	_smoothFill = 0;
 	_smoothSpeed = 0.5f;
+
+	uTintID = -1;
+	uColorizeTintID = -1;
+	uTintStrengthID = -1;
 }
 
 PQHealthBar::~PQHealthBar()
@@ -35,12 +39,15 @@ void PQHealthBar::GetLoadTasks(vector<function<void()>> &loadTasks)
 		tintShader = AddChild(make_shared<Shader>());
 		tintShader->Load("assets\\Shaders\\default.vert",
 						 "assets\\Shaders\\tinted.frag");
+		uTintID = tintShader->GetUniformID("uTint");
 	});
 
 	loadTasks.emplace_back([this]{
 		colorizeShader = AddChild(make_shared<Shader>());
 		colorizeShader->Load("assets\\Shaders\\default.vert",
 							 "assets\\Shaders\\colorize.frag");
+		uColorizeTintID = colorizeShader->GetUniformID("uTint");
+		uTintStrengthID = colorizeShader->GetUniformID("uTintStrength");
 	});
 
 	loadTasks.emplace_back([this]{
@@ -118,9 +125,7 @@ void PQHealthBar::DoRedPulse()
 		filler->SetShader(colorizeShader);
 
 		colorizeShader->SetActive();
-		colorizeShader->SetUniform("uTint", Color::red);
-		
-		int idTintStrength = colorizeShader->GetUniformID("uTintStrength");
+		colorizeShader->SetUniform(uColorizeTintID, Color::red);
 
 		float length = 2.0f;
 		float start = Time::time();
@@ -144,7 +149,7 @@ void PQHealthBar::DoRedPulse()
 			border->SetScale(barScale);
 
 			colorizeShader->SetActive();
-			colorizeShader->SetUniform(idTintStrength, c);
+			colorizeShader->SetUniform(uTintStrengthID, c);
 
 			yield(0);
 		}
@@ -171,8 +176,6 @@ void PQHealthBar::DoBlackPulse()
 		border->SetShader(tintShader);
 		filler->SetShader(tintShader);
 
-		int id = tintShader->GetUniformID("uTint");
-		
 		float length = 2.0f;
 		float start = Time::time();
 		float finish = start + length;
@@ -195,7 +198,7 @@ void PQHealthBar::DoBlackPulse()
 			border->SetScale(barScale);
 
 			tintShader->SetActive();
-			tintShader->SetUniform(id, Color(c, c, c));
+			tintShader->SetUniform(uTintID, Color(c, c, c));
 
 			yield(0);
 		}
@@ -49,6 +49,9 @@ public:
 private:
 	shared_ptr<Shader> tintShader;
 	shared_ptr<Shader> colorizeShader;
+	int uTintID;
+	int uColorizeTintID;
+	int uTintStrengthID;
 	shared_ptr<Sprite> heart;
 	shared_ptr<Sprite> background;
 	shared_ptr<Sprite> border;
@@ -15,6 +15,7 @@ PQPathFinder::PQPathFinder(Graph *graph, vector<GraphNode*> *goals, float speed)
 	pGoals = goals;
 	following = false;
 	minDistToNextGoal = 1000;
+	rng = Random::NewStream();
 }
 
 PQPathFinder::~PQPathFinder()
@@ -24,7 +25,7 @@ PQPathFinder::~PQPathFinder()
 
 void PQPathFinder::Start()
 {
-	tween = AddChild(make_shared<MotionTween>());
+	tween = AddChild(New<MotionTween>());
 	FollowPath();
 }
 
@@ -36,7 +37,7 @@ void PQPathFinder::Update()
 		{
 			following = false;
 
-			yield(Random::range(4.0f, 30.0f));
+			yield(rng.range(4.0f, 30.0f));
 			
 			int tries = 0;
 
@@ -91,8 +92,7 @@ bool PQPathFinder::FindPath()
 	if(possibleGoals.empty())
 		return false;
 
-	auto it = pGoals->begin() + (rand() % (possibleGoals.size() - 1));
-	GraphNode *end = *it;
+	GraphNode *end = possibleGoals[rng.index((uint32_t)possibleGoals.size())];
 	
 	myPath.clear();
 
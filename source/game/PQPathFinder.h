@@ -15,6 +15,7 @@
 #include <deque>
 #include "Object.h"
 #include "PQGameTypes.h"
+#include "Random.h"
 
 using namespace std;
 
@@ -30,6 +31,7 @@ protected:
 	float speed;
 	float minDistToNextGoal;
 	weak_ptr<Task> findPathRoutine;
+	Rng rng;
 
 	bool FindPath();
 
@@ -12,7 +12,7 @@
 PQPedestrian::PQPedestrian(PQGame *game)
 	: PQPathFinder(&game->pedGraph, &game->pedGoals, 60.0f)
 {
-	
+	this->game = game;
 }
 
 PQPedestrian::~PQPedestrian()
@@ -36,7 +36,7 @@ void PQPedestrian::Start()
 
 	for (int y = 0; y < nAngles; y++)
 	{
-		animations[y] = AddChild(make_shared<Animation>());
+		animations[y] = AddChild(New<Animation>());
 		animations[y]->sprite(img);
 
 		for (int x = 1; x < 17; x++)
@@ -51,12 +51,12 @@ void PQPedestrian::Start()
 	animation = nullptr;
 	isSplattered = false;
 
-	splatter = AddChild(make_shared<Sprite>(PizzaQuest::textures().splatter));
+	splatter = AddChild(New<Sprite>(PizzaQuest::textures().splatter));
 	splatter->SetVisible(true);
 	splatter->SetScale(0.5f);
 	splatter->category = 0;
 
-	body = make_shared<RigidBody>(state()->physics,
+	body = New<RigidBody>(state()->physics,
 					              Physics::toMeters(position),
 					              0.0f,
 					              RigidBody::Type::Trigger);
@@ -90,8 +90,6 @@ void PQPedestrian::LateUpdate()
 		
 		bool touchingCar = false;
 
-		auto game = state()->as<PQGame>();
-
 		for(auto it = game->cars.begin(), itEnd = game->cars.end();
 			!touchingCar && it != itEnd;
 			++it)
@@ -148,7 +146,8 @@ void PQPedestrian::LateUpdate()
 		col = 0;
 	}
 
-	body->pixelPosition(position);
+	vec2f pos = position;
+	Defer([this, pos]{ body->pixelPosition(pos); });
 }
 
 void PQPedestrian::Draw()
@@ -184,7 +183,7 @@ void PQPedestrian::SetSplattered()
 
 	isSplattered = true;
 	splatter->SetPos(position);
-	splatter->SetAngle((float)rand() / (float)RAND_MAX * 360.0f);
+	splatter->SetAngle(rng.range(0.0f, 360.0f));
 	
 	layer = DrawLayer::Tiles + 500;
 
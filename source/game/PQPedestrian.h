@@ -22,12 +22,14 @@ public:
 	Animation *animation;
 	shared_ptr<Sprite> splatter;
 	bool isSplattered;
+	PQGame *game;
 
 	PQPedestrian(PQGame *game);
 	virtual ~PQPedestrian();
 	
 	virtual void Start() override;
 	virtual void LateUpdate();
+	virtual UpdatePhase threadSafePhases() const override { return UpdatePhase::LateUpdate; }
 	virtual void Draw() override;
 	virtual string tag() const override { return "Pedestrian"; }
 	virtual void OnCollisionEnter(Contact contact) override;
@@ -10,7 +10,7 @@ using namespace coroutines;
 
 PQPizzaPickup::PQPizzaPickup()
 {
-	
+	uTintID = -1;
 }
 
 PQPizzaPickup::~PQPizzaPickup()
@@ -22,6 +22,7 @@ void PQPizzaPickup::Start()
 {
 	shader = make_shared<Shader>("assets\\Shaders\\default.vert", "assets\\Shaders\\tinted.frag");
 	AddChild(shader);
+	uTintID = shader->GetUniformID("uTint");
 
 	img->layer = DrawLayer::Tiles + 100;
 	img->SetPos(position.x, position.y);
@@ -29,7 +30,7 @@ void PQPizzaPickup::Start()
 	img->SetShader(shader);
 	img->SetStatic(true);
 
-	body = make_shared<RigidBody>(state()->physics,
+	body = New<RigidBody>(state()->physics,
 								  Physics::toMeters(position),
 								  angle,
 								  RigidBody::Type::Trigger);
@@ -51,7 +52,7 @@ void PQPizzaPickup::LateUpdate()
 		float s = sin(Time::time() * 6);
 		float c = ((s + 1.0f) * 0.5f) * 0.7f + 0.3f;
 		shader->SetActive();
-		shader->SetUniform("uTint", Color(c, c, c));
+		shader->SetUniform(uTintID, Color(c, c, c));
 	}
 }
 
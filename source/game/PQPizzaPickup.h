@@ -17,6 +17,7 @@
 class PQPizzaPickup : public PQMapImage
 {
 	shared_ptr<Shader> shader;
+	int uTintID;
 public:
 	PQPizzaPickup();
 	~PQPizzaPickup();
@@ -27,11 +27,10 @@ void PQPizzaShop::Start()
 	img->layer = DrawLayer::Structures;
 	img->SetStatic(true);
 
-	body = make_shared<RigidBody>(state()->physics,
-								  GetResource()->collision_shapes,
+	body = New<RigidBody>(state()->physics,
+								  GetResource()->b2Shapes(scale),
 								  position,
-								  RADIANS(angle),
-								  scale);
+								  RADIANS(angle));
 
 	AddChild(body);
 }
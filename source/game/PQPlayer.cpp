@@ -142,10 +142,12 @@ void PQPlayer::Start()
 	carIdle = AddChild(make_shared<Sound>());
 	carIdle->Open("assets\\Sounds\\Effects\\carIdle.wav");
 	carIdle->SetLoop(true);
+	carIdle->SetCategory(SoundCategory::Loop);
 
 	carDrive = AddChild(make_shared<Sound>());
 	carDrive->Open("assets\\Sounds\\Effects\\carDrive.wav");
 	carDrive->SetLoop(true);
+	carDrive->SetCategory(SoundCategory::Loop);
 
 	nitrous = AddChild(make_shared<Sound>());
 	nitrous->Open("assets\\Sounds\\Effects\\nitrous.wav");
@@ -29,7 +29,7 @@ void PQPowerUp::Start()
 	img->SetRow(0);
 	img->SetStatic(true);
 
-	body = make_shared<RigidBody>(state()->physics,
+	body = New<RigidBody>(state()->physics,
 								  Physics::toMeters(position),
 								  angle,
 								  RigidBody::Type::Trigger);
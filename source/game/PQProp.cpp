@@ -17,14 +17,19 @@ PQProp::~PQProp()
 
 void PQProp::Start()
 {
-	PQMapImage::Start();
-
-	body->self_mask(ContactMask::Prop);
-	body->others_mask(ContactMask::Player | ContactMask::Vehicle);
-
 	img->layer = DrawLayer::Props;
 	img->SetPos(position.x, position.y);
 	img->SetAngle(angle);
 	img->SetScale(scale);
 	img->SetStatic(true);
 }
+
+void PQProp::AddCollision(StaticCollision &collision)
+{
+	collision.Add(this,
+				  GetResource()->b2Shapes(scale),
+				  position,
+				  RADIANS(angle),
+				  ContactMask::Prop,
+				  ContactMask::Player | ContactMask::Vehicle);
+}
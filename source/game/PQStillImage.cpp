@@ -8,7 +8,7 @@
 PQStillImage::PQStillImage(const StillImageDesc &desc)
 	: desc(desc)
 {
-
+	uTintID = -1;
 }
 
 PQStillImage::~PQStillImage()
@@ -27,6 +27,7 @@ void PQStillImage::Start()
 	shader = AddChild(make_shared<Shader>());
 	shader->Load("assets\\Shaders\\default.vert",
 				 "assets\\Shaders\\tinted.frag");
+	uTintID = shader->GetUniformID("uTint");
 
 	image = AddChild(make_shared<Sprite>(shader));
 	image->Open(desc.fnImage.c_str());
@@ -55,13 +56,13 @@ void PQStillImage::Start()
 			float t = (Time::exactTime() - start) / length;
 
 			shader->SetActive();
-			shader->SetUniform("uTint", Color(t, t, t));
+			shader->SetUniform(uTintID, Color(t, t, t));
 
 			yield(0);
 		}
 
 		shader->SetActive();
-		shader->SetUniform("uTint", Color::white);
+		shader->SetUniform(uTintID, Color::white);
 
 		yield(desc.sustainLength);
 
@@ -75,13 +76,13 @@ void PQStillImage::Start()
 			float c = 1.0f - t;
 
 			shader->SetActive();
-			shader->SetUniform("uTint", Color(c, c, c));
+			shader->SetUniform(uTintID, Color(c, c, c));
 
 			yield(0);
 		}
 
 		shader->SetActive();
-		shader->SetUniform("uTint", Color::black);
+		shader->SetUniform(uTintID, Color::black);
 
 		if(desc.callback)
 			desc.callback();
@@ -72,6 +72,7 @@ private:
 	StillImageDesc desc;
 	shared_ptr<Camera> camera;
 	shared_ptr<Shader> shader;
+	int uTintID;
 	shared_ptr<Sprite> image;
 	shared_ptr<Sound> sound;
 	bool done;
@@ -12,13 +12,18 @@ PQStructure::PQStructure()
 
 void PQStructure::Start()
 {
-	PQMapImage::Start();
-	
 	img->layer = DrawLayer::Structures;
 	img->SetStatic(true);
+}
 
-	body->self_mask(ContactMask::Structure);
-	body->others_mask(ContactMask::Player | ContactMask::Vehicle);
+void PQStructure::AddCollision(StaticCollision &collision)
+{
+	collision.Add(this,
+				  GetResource()->b2Shapes(scale),
+				  position,
+				  RADIANS(angle),
+				  ContactMask::Structure,
+				  ContactMask::Player | ContactMask::Vehicle);
 }
 
 PQStructure::~PQStructure()
@@ -20,15 +20,15 @@ void PQTile::Start()
 {
 	img->layer = DrawLayer::Tiles;
 	img->SetStatic(true);
-	
-	body = make_shared<RigidBody>(state()->physics,
-								  GetResource()->collision_shapes,
-								  position,
-								  RADIANS(angle),
-								  scale);
-	body->friction(0);
-	body->self_mask(ContactMask::Tile);
-	body->others_mask(ContactMask::Vehicle);
+}
 
-	AddChild(body);
+void PQTile::AddCollision(StaticCollision &collision)
+{
+	collision.Add(this,
+				  GetResource()->b2Shapes(scale),
+				  position,
+				  RADIANS(angle),
+				  ContactMask::Tile,
+				  ContactMask::Vehicle,
+				  0.0f);
 }
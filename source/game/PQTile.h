@@ -7,6 +7,7 @@
 
 #include "Object.h"
 #include "PQGameTypes.h"
+#include "StaticCollision.h"
 
 class PQTile : public PQMapImage
 {
@@ -16,4 +17,7 @@ public:
 
 	virtual void Start() override;
 	virtual string tag() const override { return "Tile"; }
+
+	// merges this object's collision shapes into the map's static bodies
+	void AddCollision(StaticCollision &collision);
 };
@@ -103,7 +103,7 @@ void PQVehicle::Start()
 	degreesPerCol = 360.0f / (float)nAngles;
 	angleTolerance = degreesPerCol / 2.0f;
 	
-	body = make_shared<RigidBody>(state()->physics,
+	body = New<RigidBody>(state()->physics,
 								  Physics::toMeters(position),
 								  math::rad(angle - 90.0f),
 								  RigidBody::Type::Dynamic);
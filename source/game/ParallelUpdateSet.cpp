@@ -0,0 +1,114 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "ParallelUpdateSet.h"
+#include "ThreadPool.h"
+#include "Object.h"
+#include <algorithm>
+
+thread_local bool ParallelUpdateSet::_running = false;
+
+void ParallelUpdateSet::Add(Object *obj, UpdatePhase phases)
+{
+	if((phases & UpdatePhase::Update) != UpdatePhase::None)
+		_add(_update, 0, obj);
+
+	if((phases & UpdatePhase::LateUpdate) != UpdatePhase::None)
+		_add(_lateUpdate, 1, obj);
+}
+
+void ParallelUpdateSet::Remove(Object *obj)
+{
+	_remove(_update, 0, obj);
+	_remove(_lateUpdate, 1, obj);
+}
+
+void ParallelUpdateSet::Run(UpdatePhase phase)
+{
+	_run(phase == UpdatePhase::Update ? _update : _lateUpdate, phase);
+}
+
+void ParallelUpdateSet::_add(vector<Bucket> &buckets, int list, Object *obj)
+{
+	type_index type(typeid(*obj));
+
+	auto it = find_if(buckets.begin(), buckets.end(),
+		[&](const Bucket &b){ return b.type == type; });
+
+	if(it == buckets.end())
+	{
+		buckets.emplace_back(type);
+		it = buckets.end() - 1;
+	}
+
+	obj->_parallelBucket[list] = (uint32_t)(it - buckets.begin());
+	obj->_parallelSlot[list] = (uint32_t)it->objects.size();
+	it->objects.push_back(obj);
+}
+
+void ParallelUpdateSet::_remove(vector<Bucket> &buckets, int list, Object *obj)
+{
+	// may be called from ~Object, where typeid no longer gives the bucket's
+	// type, so the object remembers where it is
+	uint32_t slot = obj->_parallelSlot[list];
+
+	if(slot == 0xFFFFFFFF)
+		return;
+
+	vector<Object*> &objects = buckets[obj->_parallelBucket[list]].objects;
+
+	Object *last = objects.back();
+	objects[slot] = last;
+	last->_parallelSlot[list] = slot;
+	objects.pop_back();
+
+	obj->_parallelBucket[list] = 0xFFFFFFFF;
+	obj->_parallelSlot[list] = 0xFFFFFFFF;
+}
+
+void ParallelUpdateSet::_run(vector<Bucket> &buckets, UpdatePhase phase)
+{
+	for(auto &b : buckets)
+	{
+		Object **objects = b.objects.data();
+
+		if(phase == UpdatePhase::Update)
+		{
+			ThreadPool::ParallelFor(b.objects.size(), 16, [objects](size_t begin, size_t end){
+				_running = true;
+
+				for(size_t i = begin; i < end; ++i)
+					objects[i]->Update();
+
+				_running = false;
+			});
+		}
+		else
+		{
+			ThreadPool::ParallelFor(b.objects.size(), 16, [objects](size_t begin, size_t end){
+				_running = true;
+
+				for(size_t i = begin; i < end; ++i)
+					objects[i]->LateUpdate();
+
+				_running = false;
+			});
+		}
+	}
+
+	// collect the deferred structural changes in array order so the result
+	// doesn't depend on which worker ran which object. They only run once
+	// they're all collected, since they may remove objects from the buckets.
+	vector<function<void()>> commands;
+
+	for(auto &b : buckets)
+	{
+		for(Object *obj : b.objects)
+			obj->TakeDeferred(commands);
+	}
+
+	for(auto &fx : commands)
+		fx();
+}
@@ -0,0 +1,58 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <vector>
+#include <typeindex>
+#include <cstdint>
+#include "EnumBitmask.h"
+
+using namespace std;
+
+class Object;
+
+enum class UpdatePhase : uint32_t
+{
+	None = 0,
+	Update = 1,
+	LateUpdate = 2,
+	PreDrawUpdate = 4,
+	Draw = 8,
+	All = 15
+};
+
+ENUM_BITMASK(UpdatePhase)
+
+// Objects of a State that declared thread-safe update phases, grouped by
+// concrete type so each ParallelFor runs the same code over a flat array.
+class ParallelUpdateSet
+{
+	struct Bucket
+	{
+		Bucket(type_index type) : type(type){}
+
+		type_index type;
+		vector<Object*> objects;
+	};
+
+	vector<Bucket> _update;
+	vector<Bucket> _lateUpdate;
+
+	static thread_local bool _running;
+
+	static void _add(vector<Bucket> &buckets, int list, Object *obj);
+	static void _remove(vector<Bucket> &buckets, int list, Object *obj);
+	static void _run(vector<Bucket> &buckets, UpdatePhase phase);
+
+public:
+	void Add(Object *obj, UpdatePhase phases);
+	void Remove(Object *obj);
+	void Run(UpdatePhase phase);
+
+	// true on a thread while it runs objects of a parallel phase
+	static bool running() {
+		return _running;
+	}
+};
@@ -6,6 +6,7 @@
 #include "ParticleSystem.h"
 #include "Camera.h"
 #include "Graphics.h"
+#include "MathBatch.h"
 
 ParticleSystem::ParticleSystem()
 {
@@ -43,7 +44,8 @@ ParticleSystem::ParticleSystem()
 	forceScale = crv::constant;
 	alphaScale = crv::constant;
 
-	shader = Graphics::defaultShader();
+	SetShader(Graphics::defaultShader());
+	rng = Random::NewStream();
 }
 
 ParticleSystem::~ParticleSystem()
@@ -69,6 +71,24 @@ void ParticleSystem::SetTexture(shared_ptr<Texture> texture)
 void ParticleSystem::SetShader(shared_ptr<Shader> shader)
 {
 	this->shader = shader;
+
+	aPositionID = -1;
+	aTexCoordID = -1;
+	aColorID = -1;
+	uMainTexID = -1;
+	uMtxMvpID = -1;
+
+	if(!shader)
+		return;
+
+	aPositionID = shader->GetAttribID("aPosition");
+	aTexCoordID = shader->GetAttribID("aTexCoord");
+	uMainTexID  = shader->GetUniformID("uMainTex");
+	uMtxMvpID   = shader->GetUniformID("uMtxMVP");
+
+	// per-particle color is optional
+	if(shader->HasAttrib("aColor"))
+		aColorID = shader->GetAttribID("aColor");
 }
 
 void ParticleSystem::SetRadius(float radius)
@@ -109,8 +129,6 @@ void ParticleSystem::SetMaxParticles(uint32_t maxParticles)
 		indices[i + 5] = d;
 	}
 
-	vertexBuffer.SetData(nullptr, numVerts * sizeof(vec2f), DrawBuffer::Type::VertexData, true);
-	colorBuffer.SetData(nullptr, numVerts * sizeof(Color), DrawBuffer::Type::VertexData, true);
 	texBuffer.SetData(texcoords.data(), numVerts * sizeof(vec2f), DrawBuffer::Type::VertexData);
 	indexBuffer.SetData(indices.data(), numIndices * sizeof(uint32_t), DrawBuffer::Type::IndexData);
 }
@@ -184,23 +202,44 @@ bool ParticleSystem::emit()
 	return _emit;
 }
 
+// same distribution as Rng::vector2, from three uniform values
+vec2f ParticleSystem::_diskPoint(const float *r)
+{
+	float a = r[0] * math::twopi;
+	float d = r[1] + r[2];
+	d = d > 1 ? 2 - d : d;
+
+	return vec2f(d * cos(a), d * sin(a));
+}
+
 void ParticleSystem::Spawn(uint32_t count)
 {
 	count = min(maxParticles - particles.size(), count);
-	
+
+	// 6 variations in [-1, 1) followed by two angle/radius triples in [0, 1)
+	const size_t stride = 12;
+
+	randoms.resize(count * stride);
+	rng.fill(randoms.data(), randoms.size());
+
 	for(uint32_t i = 0; i < count; ++i)
 	{
 		particles.emplace_back();
 		Particle &p = particles.back();
 
+		float *r = &randoms[i * stride];
+
+		for(int j = 0; j < 6; ++j)
+			r[j] = r[j] * 2.0f - 1.0f;
+
 		p.birth = Time::time();
-		p.death = p.birth + life + Random::signedValue() * lifeVariation;
-		p.position = _position + Random::vector2() * radius;
-		p.velocity = Random::vector2().Normalized() * (startSpeed + Random::signedValue() * speedVariation);
-		p.rotation = startRotation + Random::signedValue() * rotationVariation;
-		p.scale = startScale + Random::signedValue() * scaleVariation;
-		p.angularVelocity = startAngularVelocity + Random::signedValue() * angularVelocityVariation;
-		p.alpha = startAlpha + Random::signedValue() * alphaVariation;
+		p.death = p.birth + life + r[0] * lifeVariation;
+		p.position = _position + _diskPoint(r + 6) * radius;
+		p.velocity = _diskPoint(r + 9).Normalized() * (startSpeed + r[1] * speedVariation);
+		p.rotation = startRotation + r[2] * rotationVariation;
+		p.scale = startScale + r[3] * scaleVariation;
+		p.angularVelocity = startAngularVelocity + r[4] * angularVelocityVariation;
+		p.alpha = startAlpha + r[5] * alphaVariation;
 	}
 }
 
@@ -248,10 +287,11 @@ void ParticleSystem::Update()
 			float hws = hw * scale;
 			float hhs = hh * scale;
 
-			vertices[a] = vec2f(xf, -hws, -hhs);
-			vertices[b] = vec2f(xf, -hws,  hhs);
-			vertices[c] = vec2f(xf,  hws,  hhs);
-			vertices[d] = vec2f(xf,  hws, -hhs);
+			vertices[a] = vec2f(-hws, -hhs);
+			vertices[b] = vec2f(-hws,  hhs);
+			vertices[c] = vec2f( hws,  hhs);
+			vertices[d] = vec2f( hws, -hhs);
+			math::TransformPoints(xf, &vertices[a], &vertices[a], 4);
 
 			Color color(1, 1, 1, alpha);
 			colors[a] = color;
@@ -280,11 +320,6 @@ void ParticleSystem::Update()
 
 		lastSpawn = Time::time();
 	}
-
-	uint32_t vertsToUpdate = particles.size() * 4;
-
-	vertexBuffer.UpdateData(vertices.data(), 0, vertsToUpdate * sizeof(vec2f));
-	colorBuffer.UpdateData(colors.data(), 0, vertsToUpdate * sizeof(Color));
 }
 
 void ParticleSystem::Draw()
@@ -295,12 +330,26 @@ void ParticleSystem::Draw()
 	|| particles.empty())
 		return;
 
+	// positions, then colors
+	uint32_t vertCount = particles.size() * 4;
+	uint32_t positionBytes = vertCount * sizeof(vec2f);
+	uint32_t colorBytes = vertCount * sizeof(Color);
+
+	StreamRange range;
+	uint8_t *p = (uint8_t*)Graphics::stream().Map(positionBytes + colorBytes, sizeof(Color), range);
+	if(!p)
+		return;
+
+	memcpy(p, vertices.data(), positionBytes);
+	memcpy(p + positionBytes, colors.data(), colorBytes);
+	Graphics::stream().Unmap();
+
 	shader->SetActive();
-	shader->SetUniform("uMainTex", texture.get());
-	shader->SetUniform("uMtxMVP", Camera::activeCamera()->matrix());
-	shader->SetVertexBuffer("aPosition", &vertexBuffer);
-	shader->SetVertexBuffer("aTexCoord", &texBuffer);
-	shader->SetVertexBuffer("aColor", &colorBuffer);
+	shader->SetUniform(uMainTexID, texture.get());
+	shader->SetUniform(uMtxMvpID, Camera::activeCamera()->matrix());
+	shader->SetVertexBuffer(aPositionID, range.buffer, 0, range.offset);
+	shader->SetVertexBuffer(aTexCoordID, &texBuffer);
+	shader->SetVertexBuffer(aColorID, range.buffer, 0, range.offset + positionBytes);
 	shader->SetIndexBuffer(&indexBuffer);
 	
 	Graphics::DrawIndexed(0, particles.size() * 6, DrawMode::Triangles);
@@ -8,6 +8,7 @@
 #include "Math.h"
 #include "Object.h"
 #include "curves.h"
+#include "Random.h"
 #include <vector>
 #include <algorithm>
 using namespace std;
@@ -16,6 +17,7 @@ class ParticleSystem : public Object
 {
 	bool _getEmit();
 	void _setEmit(bool emit);
+	static vec2f _diskPoint(const float *r);
 public:
 	struct Particle
 	{
@@ -94,6 +96,8 @@ private:
 	crv::function_t alphaScale;
 
 	vector<Particle> particles;
+	vector<float> randoms;
+	Rng rng;
 	vector<vec2f> vertices;
 	vector<vec2f> texcoords;
 	vector<Color> colors;
@@ -101,9 +105,12 @@ private:
 	
 	shared_ptr<Texture> texture;
 	shared_ptr<Shader> shader;
+	int aPositionID;
+	int aTexCoordID;
+	int aColorID;
+	int uMainTexID;
+	int uMtxMvpID;
 
-	DrawBuffer vertexBuffer;
-	DrawBuffer colorBuffer;
 	DrawBuffer texBuffer;
 	DrawBuffer indexBuffer;
 };
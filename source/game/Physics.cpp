@@ -8,14 +8,29 @@
 #include "Object.h"
 #include <Box2D.h>
 #include "Time.h"
+#include "Profiler.h"
+#include "Counters.h"
 
-Contact::Contact(RigidBody* body, vec2f point, vec2f normal)
+static Counter physicsBodies("physics.bodies", Counters::Kind::Gauge);
+static Counter physicsContacts("physics.contacts", Counters::Kind::Gauge);
+
+Contact::Contact(RigidBody* body, Object* owner, vec2f point, vec2f normal)
 		: body(body),
+		  owner(owner),
 		  point(point),
 		  normal(normal)
 {
 }
 
+// fixtures of merged static bodies carry their owner, see StaticCollision
+static shared_ptr<Object> FixtureOwner(b2Fixture *fixture)
+{
+	if(Object *owner = (Object*)fixture->GetUserData())
+		return owner->shared_from_this();
+
+	return ((RigidBody*)fixture->GetBody()->GetUserData())->parent();
+}
+
 class CollisionProxy : public b2ContactListener
 {
 public:
@@ -34,11 +49,11 @@ public:
 		RigidBody* rbA = (RigidBody*)bodyA->GetUserData();
 		RigidBody* rbB = (RigidBody*)bodyB->GetUserData();
 
-		auto parentA = rbA->parent();
-		auto parentB = rbB->parent();
+		auto parentA = FixtureOwner(contact->GetFixtureA());
+		auto parentB = FixtureOwner(contact->GetFixtureB());
 
-		if(parentA) parentA->OnCollisionEnter(Contact(rbB, contactPoint, normalA));
-		if(parentB) parentB->OnCollisionEnter(Contact(rbA, contactPoint, normalB));
+		if(parentA) parentA->OnCollisionEnter(Contact(rbB, parentB.get(), contactPoint, normalA));
+		if(parentB) parentB->OnCollisionEnter(Contact(rbA, parentA.get(), contactPoint, normalB));
 	}
 
 	virtual void CollisionProxy::EndContact(b2Contact* contact) override
@@ -56,11 +71,11 @@ public:
 		RigidBody* rbA = (RigidBody*)bodyA->GetUserData();
 		RigidBody* rbB = (RigidBody*)bodyB->GetUserData();
 
-		auto parentA = rbA->parent();
-		auto parentB = rbB->parent();
+		auto parentA = FixtureOwner(contact->GetFixtureA());
+		auto parentB = FixtureOwner(contact->GetFixtureB());
 
-		if(parentA) parentA->OnCollisionExit(Contact(rbB, contactPoint, normalA));
-		if(parentB) parentB->OnCollisionExit(Contact(rbA, contactPoint, normalB));
+		if(parentA) parentA->OnCollisionExit(Contact(rbB, parentB.get(), contactPoint, normalA));
+		if(parentB) parentB->OnCollisionExit(Contact(rbA, parentA.get(), contactPoint, normalB));
 	}
 };
 
@@ -80,7 +95,14 @@ Physics::~Physics()
 
 void Physics::Update()
 {
+	PROFILE_ZONE("Physics::Update");
 	_world->Step(Time::deltaTime(), 10, 10);
+
+	if(Counters::dumping())
+	{
+		physicsBodies.Set(_world->GetBodyCount());
+		physicsContacts.Set(_world->GetContactCount());
+	}
 }
 
 b2World *Physics::world()
@@ -20,10 +20,11 @@ struct b2Vec2;
 struct Contact
 {
 	RigidBody* body;
+	Object* owner; // the object the touched fixture belongs to
 	vec2f point;
 	vec2f normal;
 
-	Contact(RigidBody* body, vec2f point, vec2f normal);
+	Contact(RigidBody* body, Object* owner, vec2f point, vec2f normal);
 };
 
 class Physics
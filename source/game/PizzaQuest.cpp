@@ -4,6 +4,7 @@
 *--------------------------------------------------------------------------------------------*/
 
 #include "PizzaQuest.h"
+#include "PQBenchmark.h"
 
 shared_ptr<SharedSounds> PizzaQuest::_sounds;
 shared_ptr<SharedTextures> PizzaQuest::_textures;
@@ -33,6 +34,12 @@ void PizzaQuest::OnInitialize()
 		PlayerProfile::AddMap("assets\\Map06.pqm", "assets\\Sounds\\Music\\DrivingTechno.mp3");
 	}
 
+	if(PQBenchmark::enabled())
+	{
+		PQBenchmark::Run();
+		return;
+	}
+
 	StillImageDesc ggamesLogoDesc;
 	ggamesLogoDesc.fadeInLength = 0.5f;
 	ggamesLogoDesc.sustainLength = 5;
@@ -63,5 +70,7 @@ void PizzaQuest::OnTerminate()
 	_sounds.reset();
 	_textures.reset();
 
-	PlayerProfile::SaveProfile("player.dat");
+	// benchmark runs don't count as played levels
+	if(!PQBenchmark::enabled())
+		PlayerProfile::SaveProfile("player.dat");
 }
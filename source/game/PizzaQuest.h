@@ -32,6 +32,10 @@ public:
 		scream = make_shared<Sound>("assets\\Sounds\\Effects\\scream01.wav");
 		whip = make_shared<Sound>("assets\\Sounds\\Effects\\whip.wav");
 		error = make_shared<Sound>("assets\\Sounds\\Effects\\error.wav");
+
+		button->SetCategory(SoundCategory::Interface);
+		error->SetCategory(SoundCategory::Interface);
+		explosion->SetPriority(1);
 	}
 };
 
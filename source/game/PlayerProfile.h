@@ -8,7 +8,7 @@
 #include <fstream>
 #include <string>
 #include "Path.h"
-#include "Singleton.h"
+#include "EngineContext.h"
 #include <vector>
 #include <memory>
 using namespace std;
@@ -39,7 +39,7 @@ public:
 	bool completed;
 };
 
-class PlayerProfile : public Singleton<PlayerProfile>
+class PlayerProfile : public ContextSingleton<PlayerProfile>
 {
 	vector<LevelData> levels;
 	size_t _currentLevel;
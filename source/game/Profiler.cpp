@@ -0,0 +1,221 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "Profiler.h"
+#include "bytestream.h"
+#include "utils.h"
+#include <Windows.h>
+#include <algorithm>
+#include <cstdio>
+
+atomic<bool> Profiler::_enabled(false);
+thread_local Profiler::RingLease Profiler::_lease;
+
+Profiler::RingLease::~RingLease()
+{
+	if(ring)
+	{
+		lock_guard<mutex> lk(that->_lock);
+		that->_freeRings.push_back(ring);
+	}
+}
+
+Profiler::Profiler()
+{
+	_historyHead = 0;
+	_historyCount = 0;
+	_lastFrame = 0;
+}
+
+Profiler::~Profiler()
+{
+}
+
+void Profiler::Enable(bool enable)
+{
+	if(enable && !enabled())
+	{
+		that->_historyCount = 0;
+		that->_lastFrame = 0;
+
+		// drop the previous capture. The heads belong to the recording
+		// threads, so the rings are cleared by moving their start instead.
+		lock_guard<mutex> lk(that->_lock);
+
+		for(auto &ring : that->_rings)
+		{
+			ring->start = ring->head.load(memory_order_acquire);
+			ring->collected = ring->start;
+		}
+	}
+
+	_enabled.store(enable, memory_order_relaxed);
+}
+
+Profiler::Ring *Profiler::_acquireRing()
+{
+	lock_guard<mutex> lk(_lock);
+
+	// zones left in a reused ring keep the id of the thread that wrote them
+	if(!_freeRings.empty())
+	{
+		Ring *ring = _freeRings.back();
+		_freeRings.pop_back();
+		return ring;
+	}
+
+	_rings.emplace_back(new Ring());
+	_rings.back()->head = 0;
+	_rings.back()->collected = 0;
+	_rings.back()->start = 0;
+	return _rings.back().get();
+}
+
+void Profiler::Record(const char *name, long long begin, long long end)
+{
+	RingLease &lease = _lease;
+
+	if(!lease.ring)
+	{
+		lease.ring = that->_acquireRing();
+		lease.threadID = GetCurrentThreadId();
+	}
+
+	Ring *ring = lease.ring;
+
+	uint64_t head = ring->head.load(memory_order_relaxed);
+
+	Zone &zone = ring->zones[head & (RingSize - 1)];
+	zone.name = name;
+	zone.begin = begin;
+	zone.end = end;
+	zone.threadID = lease.threadID;
+
+	ring->head.store(head + 1, memory_order_release);
+}
+
+void Profiler::SetThreadName(const char *name)
+{
+	lock_guard<mutex> lk(that->_lock);
+	that->_threadNames[GetCurrentThreadId()] = name;
+}
+
+void Profiler::EndFrame()
+{
+	if(!enabled())
+		return;
+
+	long long now = Time::ticks();
+
+	if(that->_lastFrame)
+	{
+		that->_history[that->_historyHead] = (float)((double)(now - that->_lastFrame) * 1000.0 / (double)Time::frequency());
+		that->_historyHead = (that->_historyHead + 1) % HistorySize;
+		that->_historyCount = min(that->_historyCount + 1, (int)HistorySize);
+	}
+
+	that->_lastFrame = now;
+}
+
+float Profiler::frameTime(int framesAgo)
+{
+	if(framesAgo < 0 || framesAgo >= that->_historyCount)
+		return 0;
+
+	return that->_history[(that->_historyHead - 1 - framesAgo + HistorySize) % HistorySize];
+}
+
+int Profiler::frameCount()
+{
+	return that->_historyCount;
+}
+
+uint64_t Profiler::_copyZones(Ring &ring, uint64_t from, vector<Zone> &zones)
+{
+	uint64_t head = ring.head.load(memory_order_acquire);
+	uint64_t first = max<uint64_t>(from, head > RingSize ? head - RingSize : 0);
+
+	size_t start = zones.size();
+
+	for(uint64_t i = first; i < head; ++i)
+		zones.push_back(ring.zones[i & (RingSize - 1)]);
+
+	// the owner may have kept recording while we copied, drop any
+	// slot it could have overwritten in the meantime
+	uint64_t after = ring.head.load(memory_order_acquire);
+
+	if(after + 1 > first + RingSize)
+	{
+		size_t torn = (size_t)min<uint64_t>(after + 1 - (first + RingSize), head - first);
+		zones.erase(zones.begin() + start, zones.begin() + start + torn);
+	}
+
+	return head;
+}
+
+void Profiler::Collect(vector<Zone> &zones)
+{
+	lock_guard<mutex> lk(that->_lock);
+
+	for(auto &ring : that->_rings)
+		ring->collected = _copyZones(*ring, ring->collected, zones);
+}
+
+bool Profiler::ExportChromeTrace(const string &filename)
+{
+	vector<Zone> zones;
+	unordered_map<uint32_t, string> names;
+
+	{
+		lock_guard<mutex> lk(that->_lock);
+
+		for(auto &ring : that->_rings)
+			_copyZones(*ring, ring->start, zones);
+
+		names = that->_threadNames;
+	}
+
+	if(zones.empty())
+		return false;
+
+	long long base = zones[0].begin;
+
+	for(auto &zone : zones)
+		base = min(base, zone.begin);
+
+	double usPerTick = 1000000.0 / (double)Time::frequency();
+
+	string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	char line[256];
+
+	for(auto &name : names)
+	{
+		snprintf(line, sizeof(line),
+				 "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}},\n",
+				 name.first, name.second.c_str());
+		json += line;
+	}
+
+	for(size_t i = 0; i < zones.size(); ++i)
+	{
+		const Zone &zone = zones[i];
+
+		snprintf(line, sizeof(line),
+				 "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+				 zone.name,
+				 zone.threadID,
+				 (double)(zone.begin - base) * usPerTick,
+				 (double)(zone.end - zone.begin) * usPerTick,
+				 i + 1 < zones.size() ? "," : "");
+		json += line;
+	}
+
+	json += "]}\n";
+
+	bytestream output;
+	output.write(json.data(), json.size());
+
+	return bytestream_to_file(filename, output);
+}
@@ -0,0 +1,129 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include "Singleton.h"
+#include "Time.h"
+
+using namespace std;
+
+// build with PQ_PROFILER=0 to compile every zone out
+#ifndef PQ_PROFILER
+#define PQ_PROFILER 1
+#endif
+
+// Scoped timing zones. Every thread records finished zones into its own ring
+// without taking a lock, and the oldest zones are overwritten once a ring is
+// full. While the profiler is disabled a zone costs one relaxed load.
+class Profiler : public Singleton<Profiler>
+{
+public:
+	static const uint32_t RingSize = 1 << 16;  // zones kept per thread
+	static const int HistorySize = 256;        // frames kept for the graph
+
+	struct Zone
+	{
+		const char *name;  // must outlive the capture, use string literals
+		long long begin;
+		long long end;
+		uint32_t threadID;
+	};
+
+	Profiler();
+	~Profiler();
+
+	static void Enable(bool enable);
+	static bool enabled() {
+		return _enabled.load(memory_order_relaxed);
+	}
+
+	static void Record(const char *name, long long begin, long long end);
+
+	// shown instead of the thread id in exported traces
+	static void SetThreadName(const char *name);
+
+	// called by the engine once per frame, on the main thread
+	static void EndFrame();
+
+	// length of a recent frame in milliseconds, 0 is the last one
+	static float frameTime(int framesAgo);
+	static int frameCount();
+
+	// appends the zones recorded since the last call, zones that were
+	// overwritten in the meantime are lost
+	static void Collect(vector<Zone> &zones);
+
+	// writes the zones of the last capture that are still in the rings as
+	// Chrome trace events, for chrome://tracing or ui.perfetto.dev
+	static bool ExportChromeTrace(const string &filename);
+
+private:
+	struct Ring
+	{
+		atomic<uint64_t> head;
+		uint64_t collected;  // only touched under _lock
+		uint64_t start;      // first zone of the current capture, under _lock
+		Zone zones[RingSize];
+	};
+
+	// gives the ring back when its thread exits
+	struct RingLease
+	{
+		Ring *ring;
+		uint32_t threadID;
+		RingLease() : ring(nullptr), threadID(0){}
+		~RingLease();
+	};
+
+	static atomic<bool> _enabled;
+	static thread_local RingLease _lease;
+
+	mutex _lock;
+	vector<unique_ptr<Ring>> _rings;
+	vector<Ring*> _freeRings;
+	unordered_map<uint32_t, string> _threadNames;
+
+	float _history[HistorySize];
+	int _historyHead;
+	int _historyCount;
+	long long _lastFrame;
+
+	Ring *_acquireRing();
+	static uint64_t _copyZones(Ring &ring, uint64_t from, vector<Zone> &zones);
+};
+
+class ProfileZone
+{
+	const char *_name;
+	long long _begin;
+public:
+	ProfileZone(const char *name)
+		: _name(name), _begin(Profiler::enabled() ? Time::ticks() : 0){}
+
+	~ProfileZone() {
+		if(_begin) Profiler::Record(_name, _begin, Time::ticks());
+	}
+
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone &operator=(const ProfileZone&) = delete;
+};
+
+#define PQ_PROFILE_CONCAT2(a, b) a##b
+#define PQ_PROFILE_CONCAT(a, b) PQ_PROFILE_CONCAT2(a, b)
+
+#if PQ_PROFILER
+  #define PROFILE_ZONE(name) ProfileZone PQ_PROFILE_CONCAT(_profileZone, __LINE__)(name)
+  #define PROFILE_THREAD(name) Profiler::SetThreadName(name)
+#else
+  #define PROFILE_ZONE(name)
+  #define PROFILE_THREAD(name)
+#endif
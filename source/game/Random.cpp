@@ -0,0 +1,116 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "Random.h"
+#include "ThreadPool.h"
+
+static uint64_t splitmix64(uint64_t &x)
+{
+	uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+// thread streams live above the ids handed out by NewStream()
+static const uint64_t ThreadStreamBase = 0xFFFFFFFF00000000ull;
+static const uint64_t OutsideStreamBase = 0xFFFFFFFF80000000ull;
+
+// pool workers keep their index. Every other thread (the main thread, Stream
+// threads, other contexts) gets its own id in the order it first draws.
+static uint64_t ThreadStreamID()
+{
+	static atomic<uint64_t> nextOutside(0);
+
+	int index = ThreadPool::threadIndex();
+
+	if(index != 0)
+		return ThreadStreamBase + (uint64_t)index;
+
+	return OutsideStreamBase + nextOutside++;
+}
+
+void Rng::seed(uint64_t s)
+{
+	uint64_t a = splitmix64(s);
+	uint64_t b = splitmix64(s);
+
+	_s[0] = (uint32_t)a;
+	_s[1] = (uint32_t)(a >> 32);
+	_s[2] = (uint32_t)b;
+	_s[3] = (uint32_t)(b >> 32);
+}
+
+vec2f Rng::vector2()
+{
+	float a = value() * math::twopi;
+	float r = value() + value();
+	r = r > 1 ? 2 - r : r;
+
+	return vec2f(r * cos(a), r * sin(a));
+}
+
+void Rng::fill(float *out, size_t count)
+{
+	for(size_t i = 0; i < count; ++i)
+		out[i] = (float)(next() >> 8) * (1.0f / 16777216.0f);
+}
+
+void Rng::fillSigned(float *out, size_t count)
+{
+	for(size_t i = 0; i < count; ++i)
+		out[i] = (float)(next() >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+// shared by every context, so a thread's stream can tell them apart
+static atomic<uint32_t> NextGeneration(0);
+
+Random::Random()
+	: _seed(0), _generation(NextGeneration++), _nextStream(0)
+{
+}
+
+void Random::Seed(uint64_t seed)
+{
+	Random *r = that;
+
+	r->_seed = seed;
+	r->_nextStream = 0;
+	r->_generation = NextGeneration++;
+}
+
+uint64_t Random::seed()
+{
+	return that->_seed;
+}
+
+Rng Random::NewStream()
+{
+	return StreamFor(that->_nextStream++);
+}
+
+Rng Random::StreamFor(uint64_t id)
+{
+	uint64_t s = that->_seed;
+	uint64_t mixed = splitmix64(s) ^ id;
+	return Rng(splitmix64(mixed));
+}
+
+Rng &Random::thread()
+{
+	static thread_local Rng rng;
+	static thread_local uint32_t generation = 0xFFFFFFFF;
+	static thread_local uint64_t id = ThreadStreamID();
+
+	uint32_t current = that->_generation;
+
+	if(generation != current)
+	{
+		rng = StreamFor(id);
+		generation = current;
+	}
+
+	return rng;
+}
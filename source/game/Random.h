@@ -0,0 +1,108 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include "Math.h"
+#include "EngineContext.h"
+
+using namespace std;
+
+// xoshiro128** generator. Small enough to embed in any object that needs its
+// own reproducible sequence.
+class Rng
+{
+	uint32_t _s[4];
+
+	static uint32_t _rotl(uint32_t x, int k) {
+		return (x << k) | (x >> (32 - k));
+	}
+
+public:
+	Rng() { seed(0); }
+	explicit Rng(uint64_t s) { seed(s); }
+
+	void seed(uint64_t s);
+
+	uint32_t next()
+	{
+		uint32_t result = _rotl(_s[1] * 5, 7) * 9;
+		uint32_t t = _s[1] << 9;
+
+		_s[2] ^= _s[0];
+		_s[3] ^= _s[1];
+		_s[1] ^= _s[2];
+		_s[0] ^= _s[3];
+		_s[2] ^= t;
+		_s[3] = _rotl(_s[3], 11);
+
+		return result;
+	}
+
+	// [0, 1)
+	float value() {
+		return (float)(next() >> 8) * (1.0f / 16777216.0f);
+	}
+
+	// [-1, 1)
+	float signedValue() {
+		return value() * 2.0f - 1.0f;
+	}
+
+	float range(float min, float max) {
+		return min + value() * (max - min);
+	}
+
+	// [0, n)
+	uint32_t index(uint32_t n) {
+		return (uint32_t)(((uint64_t)next() * n) >> 32);
+	}
+
+	// random point inside the unit circle
+	vec2f vector2();
+
+	// batch versions of value() and signedValue()
+	void fill(float *out, size_t count);
+	void fillSigned(float *out, size_t count);
+};
+
+// Streams derived from a single run seed. Every system that needs randomness
+// takes its own stream, so results only depend on the seed and the order in
+// which systems are created, never on what else consumed numbers in between.
+// The static helpers draw from a per-thread stream and are safe to call from
+// ThreadPool jobs.
+//
+// Each EngineContext has its own seed and stream ids, so games in different
+// contexts don't disturb each other's sequences.
+class Random : public ContextSingleton<Random>
+{
+	atomic<uint64_t> _seed;
+	atomic<uint32_t> _generation; // unique across contexts
+	atomic<uint64_t> _nextStream;
+
+public:
+	Random();
+
+	// resets all streams. Streams already handed out keep their sequence.
+	static void Seed(uint64_t seed);
+	static uint64_t seed();
+
+	// a new independent stream. Ids are handed out in creation order.
+	static Rng NewStream();
+
+	// the stream for a fixed, well known id
+	static Rng StreamFor(uint64_t id);
+
+	// the calling thread's stream, reseeded when Seed() is called or when
+	// the thread draws in another context
+	static Rng &thread();
+
+	static float value() { return thread().value(); }
+	static float signedValue() { return thread().signedValue(); }
+	static vec2f vector2() { return thread().vector2(); }
+	static float range(float min, float max) { return thread().range(min, max); }
+};
@@ -5,6 +5,7 @@
 
 #include "RenderQueue.h"
 #include "Object.h"
+#include "Profiler.h"
 
 void RenderQueue::Submit(Object *pObject)
 {
@@ -27,6 +28,8 @@ void RenderQueue::Sort()
 
 void RenderQueue::Execute()
 {
+	PROFILE_ZONE("RenderQueue::Execute");
+
 	for(Object *obj : that->_queue)
 		obj->Draw();
 }
@@ -4,7 +4,7 @@
 *--------------------------------------------------------------------------------------------*/
 
 #pragma once
-#include "Singleton.h"
+#include "EngineContext.h"
 #include "EnumBitmask.h"
 #include <vector>
 #include <algorithm>
@@ -28,7 +28,7 @@ enum class DrawLayer : int
 
 ENUM_BITMASK(DrawLayer)
 
-class RenderQueue : public Singleton<RenderQueue>
+class RenderQueue : public ContextSingleton<RenderQueue>
 {
 	vector<Object*> _queue;
 public:
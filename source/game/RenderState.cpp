@@ -0,0 +1,227 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "RenderState.h"
+#include <cassert>
+
+/*****************************
+RENDER STATS
+*****************************/
+
+void RenderStats::Clear()
+{
+	for(int i = 0; i < (int)StateChange::Count; ++i)
+	{
+		issued[i] = 0;
+		skipped[i] = 0;
+	}
+}
+
+uint32_t RenderStats::totalIssued() const
+{
+	uint32_t total = 0;
+
+	for(int i = 0; i < (int)StateChange::Count; ++i)
+		total += issued[i];
+
+	return total;
+}
+
+uint32_t RenderStats::totalSkipped() const
+{
+	uint32_t total = 0;
+
+	for(int i = 0; i < (int)StateChange::Count; ++i)
+		total += skipped[i];
+
+	return total;
+}
+
+/*****************************
+RENDER STATE
+*****************************/
+
+RenderState::RenderState()
+{
+	Reset();
+}
+
+void RenderState::Reset()
+{
+	_program = Unknown;
+	_activeUnit = -1;
+	_arrayBuffer = Unknown;
+	_elementBuffer = Unknown;
+	_enabledAttribs = 0;
+	_attribsKnown = false;
+
+	for(auto &texture : _textures)
+		texture = Unknown;
+
+	for(auto &attrib : _attribs)
+		attrib.buffer = Unknown;
+}
+
+void RenderState::Record(StateChange change, bool issued)
+{
+	if(issued)
+		++_frame.issued[(int)change];
+	else
+		++_frame.skipped[(int)change];
+}
+
+void RenderState::UseProgram(GLuint program)
+{
+	bool issue = program != _program;
+
+	if(issue)
+	{
+		glUseProgram(program);
+		_program = program;
+	}
+
+	Record(StateChange::Program, issue);
+}
+
+void RenderState::BindTexture(int unit, GLuint texture)
+{
+	assert(unit >= 0 && unit < MaxTextureUnits);
+
+	bool issue = _textures[unit] != texture;
+
+	if(issue)
+	{
+		if(_activeUnit != unit)
+		{
+			glActiveTexture(GL_TEXTURE0 + unit);
+			_activeUnit = unit;
+		}
+
+		glBindTexture(GL_TEXTURE_2D, texture);
+		_textures[unit] = texture;
+	}
+
+	Record(StateChange::Texture, issue);
+}
+
+void RenderState::BindTextureForEdit(GLuint texture)
+{
+	if(_activeUnit != 0)
+	{
+		glActiveTexture(GL_TEXTURE0);
+		_activeUnit = 0;
+	}
+
+	BindTexture(0, texture);
+}
+
+void RenderState::BindBuffer(GLenum target, GLuint buffer)
+{
+	GLuint &bound = target == GL_ELEMENT_ARRAY_BUFFER ? _elementBuffer : _arrayBuffer;
+
+	bool issue = bound != buffer;
+
+	if(issue)
+	{
+		glBindBuffer(target, buffer);
+		bound = buffer;
+	}
+
+	Record(StateChange::Buffer, issue);
+}
+
+void RenderState::EnableAttribs(uint32_t mask)
+{
+	uint32_t changed = _attribsKnown ? (mask ^ _enabledAttribs) : 0xFFFFFFFF;
+
+	for(int i = 0; i < MaxVertexAttribs; ++i)
+	{
+		uint32_t bit = 1u << i;
+
+		if(!(changed & bit))
+			continue;
+
+		if(mask & bit)
+			glEnableVertexAttribArray(i);
+		else
+			glDisableVertexAttribArray(i);
+	}
+
+	Record(StateChange::Attribute, changed != 0);
+
+	_enabledAttribs = mask;
+	_attribsKnown = true;
+}
+
+void RenderState::AttribPointer(GLint location, GLuint buffer, GLint count, GLenum type, uint32_t stride, uint32_t offset)
+{
+	assert(location >= 0 && location < MaxVertexAttribs);
+
+	Attrib &attrib = _attribs[location];
+
+	bool issue = attrib.buffer != buffer
+			  || attrib.count != count
+			  || attrib.type != type
+			  || attrib.stride != stride
+			  || attrib.offset != offset;
+
+	if(issue)
+	{
+		BindBuffer(GL_ARRAY_BUFFER, buffer);
+		glVertexAttribPointer(location, count, type, GL_FALSE, stride, (const void*)(uintptr_t)offset);
+
+		attrib.buffer = buffer;
+		attrib.count = count;
+		attrib.type = type;
+		attrib.stride = stride;
+		attrib.offset = offset;
+	}
+
+	Record(StateChange::Attribute, issue);
+}
+
+void RenderState::InvalidateProgram(GLuint program)
+{
+	if(_program == program)
+		_program = Unknown;
+}
+
+void RenderState::InvalidateTexture(GLuint texture)
+{
+	// GL reverts every unit the texture was bound to back to 0
+	for(auto &bound : _textures)
+	{
+		if(bound == texture)
+			bound = 0;
+	}
+}
+
+void RenderState::InvalidateBuffer(GLuint buffer)
+{
+	// deleting a buffer unbinds it from the targets and from any attribute
+	// that was sourcing it, and its name may be handed out again
+	if(_arrayBuffer == buffer)
+		_arrayBuffer = 0;
+
+	if(_elementBuffer == buffer)
+		_elementBuffer = 0;
+
+	for(auto &attrib : _attribs)
+	{
+		if(attrib.buffer == buffer)
+			attrib.buffer = Unknown;
+	}
+}
+
+void RenderState::EndFrame()
+{
+	_lastFrame = _frame;
+	_frame.Clear();
+}
+
+const RenderStats &RenderState::stats() const
+{
+	return _lastFrame;
+}
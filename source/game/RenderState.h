@@ -0,0 +1,93 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include "includes.h"
+#include <cstdint>
+
+enum class StateChange
+{
+	Program,
+	Texture,
+	Uniform,
+	Attribute,
+	Buffer,
+	Count
+};
+
+struct RenderStats
+{
+	RenderStats(){ Clear(); }
+
+	uint32_t issued[(int)StateChange::Count];
+	uint32_t skipped[(int)StateChange::Count];
+
+	void Clear();
+	uint32_t totalIssued() const;
+	uint32_t totalSkipped() const;
+};
+
+// Shadow copy of the GL state the engine touches. Every bind goes through here
+// and is dropped when it wouldn't change anything. Anything that deletes a GL
+// object, or binds one behind the tracker's back, has to invalidate it.
+class RenderState
+{
+public:
+	static const int MaxTextureUnits = 16;
+	static const int MaxVertexAttribs = 16;
+
+	RenderState();
+
+	// forget everything, the next call of each kind is always issued
+	void Reset();
+
+	void UseProgram(GLuint program);
+	void BindTexture(int unit, GLuint texture);
+
+	// binds 'texture' to unit 0 and makes unit 0 active, for the glTex* calls
+	// that change the texture bound to the active unit
+	void BindTextureForEdit(GLuint texture);
+	void BindBuffer(GLenum target, GLuint buffer);
+
+	// enables exactly the attribute locations set in 'mask'
+	void EnableAttribs(uint32_t mask);
+	void AttribPointer(GLint location, GLuint buffer, GLint count, GLenum type, uint32_t stride = 0, uint32_t offset = 0);
+
+	void InvalidateProgram(GLuint program);
+	void InvalidateTexture(GLuint texture);
+	void InvalidateBuffer(GLuint buffer);
+
+	void Record(StateChange change, bool issued);
+
+	// publishes this frame's counters and starts the next frame
+	void EndFrame();
+
+	// counters for the last completed frame
+	const RenderStats &stats() const;
+
+private:
+	static const GLuint Unknown = 0xFFFFFFFF;
+
+	struct Attrib
+	{
+		GLuint buffer;
+		GLint count;
+		GLenum type;
+		uint32_t stride;
+		uint32_t offset;
+	};
+
+	GLuint _program;
+	int _activeUnit;
+	GLuint _textures[MaxTextureUnits];
+	GLuint _arrayBuffer;
+	GLuint _elementBuffer;
+	uint32_t _enabledAttribs;
+	bool _attribsKnown;
+	Attrib _attribs[MaxVertexAttribs];
+
+	RenderStats _frame;
+	RenderStats _lastFrame;
+};
@@ -0,0 +1,284 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "Replay.h"
+#include "Engine.h"
+#include "Time.h"
+#include "Random.h"
+#include "Profiler.h"
+#include "Log.h"
+#include "utils.h"
+#include <sstream>
+
+// File layout, all little endian:
+//   header: uint32 magic, uint32 version, uint64 seed, float fixed step
+//   frame:  float delta time, uint16 event count, events
+//   event:  uint8 type, then uint8 key for keys, or uint8 id, float x, float y
+//           for touches, nothing for back
+
+Replay::Replay()
+{
+	_recording = false;
+	_replaying = false;
+}
+
+Replay::~Replay()
+{
+}
+
+bool Replay::StartRecording(const string &filename)
+{
+	StopRecording();
+
+	that->_file.open(filename, ios::out | ios::binary | ios::trunc);
+
+	if(!that->_file)
+	{
+		Log(LogLevel::Error, LogCategory::General, "Couldn't open input recording", filename);
+		return false;
+	}
+
+	if(Time::fixedStep() == 0)
+		Log(LogLevel::Warning, LogCategory::General, "Recording input without a fixed step, replays may diverge");
+
+	bytestream header;
+	header.write(Magic);
+	header.write(Version);
+	header.write(Random::seed());
+	header.write(Time::fixedStep());
+
+	that->_file.write(header.data(), header.size());
+	that->_pending.clear();
+	that->_recording = true;
+
+	Log(LogLevel::Info, LogCategory::General, "Recording input", filename);
+
+	return true;
+}
+
+void Replay::StopRecording()
+{
+	if(!that->_recording)
+		return;
+
+	that->_file.close();
+	that->_recording = false;
+}
+
+bool Replay::recording()
+{
+	return that->_recording;
+}
+
+bool Replay::StartReplay(const string &filename)
+{
+	StopRecording();
+
+	bytestream replay = bytestream_from_file(filename);
+
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	uint64_t seed = 0;
+	float fixedStep = 0;
+
+	if(replay.available() >= sizeof(magic) + sizeof(version) + sizeof(seed) + sizeof(fixedStep))
+	{
+		replay.read(magic);
+		replay.read(version);
+		replay.read(seed);
+		replay.read(fixedStep);
+	}
+
+	if(magic != Magic || version != Version)
+	{
+		Log(LogLevel::Error, LogCategory::General, "Not an input recording", filename);
+		return false;
+	}
+
+	if(fixedStep == 0)
+		Log(LogLevel::Warning, LogCategory::General, "Replaying input recorded without a fixed step, it may diverge");
+
+	Random::Seed(seed);
+
+	that->_replay = move(replay);
+	that->_replaying = true;
+
+	if(!that->_profileFile.empty())
+		Profiler::Enable(true);
+
+	Log(LogLevel::Info, LogCategory::General, "Replaying input", filename);
+
+	return true;
+}
+
+bool Replay::replaying()
+{
+	return that->_replaying;
+}
+
+void Replay::SetProfileOutput(const string &filename)
+{
+	that->_profileFile = filename;
+}
+
+void Replay::Configure(const string &commandLine)
+{
+	istringstream args(commandLine);
+	string arg;
+
+	while(args >> arg)
+	{
+		if(arg == "-record")
+		{
+			args >> that->_recordFile;
+		}
+		else if(arg == "-replay")
+		{
+			args >> that->_replayFile;
+		}
+		else if(arg == "-replay-profile")
+		{
+			args >> that->_profileFile;
+		}
+		else if(arg == "-fixed-fps")
+		{
+			int fps = 0;
+			if(args >> fps && fps > 0)
+				Time::SetFixedStep(1.0f / (float)fps);
+		}
+	}
+}
+
+void Replay::Begin()
+{
+	if(!that->_replayFile.empty())
+		StartReplay(that->_replayFile);
+	else if(!that->_recordFile.empty())
+		StartRecording(that->_recordFile);
+}
+
+void Replay::Record(const InputEvent &event)
+{
+	if(that->_recording)
+		that->_pending.push_back(event);
+}
+
+void Replay::Step()
+{
+	if(that->_replaying)
+	{
+		that->_replayFrame();
+		return;
+	}
+
+	Time::Step();
+
+	if(that->_recording)
+		that->_recordFrame();
+}
+
+void Replay::_recordFrame()
+{
+	// events that arrived since the last frame belong to this one
+	_frame.clear();
+	_frame.write(Time::deltaTime());
+	_frame.write((uint16_t)_pending.size());
+
+	for(auto &event : _pending)
+	{
+		_frame.write((uint8_t)event.type);
+
+		switch(event.type)
+		{
+		case InputEvent::Type::KeyDown:
+		case InputEvent::Type::KeyUp:
+			_frame.write((uint8_t)event.key);
+			break;
+
+		case InputEvent::Type::TouchDown:
+		case InputEvent::Type::TouchMove:
+		case InputEvent::Type::TouchUp:
+			_frame.write(event.id);
+			_frame.write(event.x);
+			_frame.write(event.y);
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	_file.write(_frame.data(), _frame.size());
+	_pending.clear();
+}
+
+void Replay::_replayFrame()
+{
+	float deltaTime;
+	uint16_t count;
+
+	if(_replay.available() < sizeof(deltaTime) + sizeof(count))
+	{
+		_finishReplay();
+		Time::Step();
+		return;
+	}
+
+	_replay.read(deltaTime);
+	_replay.read(count);
+
+	// dispatched before time is stepped, like live input
+	for(uint16_t i = 0; i < count; ++i)
+	{
+		uint8_t type;
+		uint8_t key;
+		InputEvent event;
+
+		_replay.read(type);
+		event.type = (InputEvent::Type)type;
+
+		switch(event.type)
+		{
+		case InputEvent::Type::KeyDown:
+		case InputEvent::Type::KeyUp:
+			_replay.read(key);
+			event.key = (KeyCode)key;
+			break;
+
+		case InputEvent::Type::TouchDown:
+		case InputEvent::Type::TouchMove:
+		case InputEvent::Type::TouchUp:
+			_replay.read(event.id);
+			_replay.read(event.x);
+			_replay.read(event.y);
+			break;
+
+		default:
+			break;
+		}
+
+		Engine::that->_dispatch(event);
+	}
+
+	Time::Step(deltaTime);
+}
+
+void Replay::_finishReplay()
+{
+	_replaying = false;
+	_replay = bytestream();
+
+	Log(LogLevel::Info, LogCategory::General, "Replay finished");
+
+	if(!_profileFile.empty())
+	{
+		Profiler::Enable(false);
+
+		if(Profiler::ExportChromeTrace(_profileFile))
+			Log(LogLevel::Info, LogCategory::General, "Wrote profiler capture", _profileFile);
+	}
+
+	Engine::QuitGame();
+}
@@ -0,0 +1,98 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include "Singleton.h"
+#include "Keycodes.h"
+#include "bytestream.h"
+
+using namespace std;
+
+struct InputEvent
+{
+	enum class Type : uint8_t
+	{
+		KeyDown,
+		KeyUp,
+		TouchDown,
+		TouchMove,
+		TouchUp,
+		Back
+	};
+
+	Type type;
+	KeyCode key;
+	uint8_t id;
+	float x;
+	float y;
+
+	InputEvent() : type(Type::Back), key((KeyCode)0), id(0), x(0), y(0){}
+	InputEvent(Type type) : type(type), key((KeyCode)0), id(0), x(0), y(0){}
+	InputEvent(Type type, KeyCode key) : type(type), key(key), id(0), x(0), y(0){}
+	InputEvent(Type type, float x, float y, int id) : type(type), key((KeyCode)0), id((uint8_t)id), x(x), y(y){}
+};
+
+// Records the input the engine receives, the length of every frame and the
+// random seed, and plays them back through the same engine entry points. A
+// replay steps time by the recorded amounts, and live input is ignored.
+//
+// Replays are only exact if the session was recorded with a fixed step,
+// otherwise code that reads the clock mid frame, like the map loader deciding
+// when to yield, can take a different path than it did while recording.
+class Replay : public Singleton<Replay>
+{
+public:
+	Replay();
+	~Replay();
+
+	static bool StartRecording(const string &filename);
+	static void StopRecording();
+	static bool recording();
+
+	// quits the game once the last recorded frame has been played
+	static bool StartReplay(const string &filename);
+	static bool replaying();
+
+	// writes a profiler capture of the whole replay to 'filename' when it ends
+	static void SetProfileOutput(const string &filename);
+
+	// handles "-record <file>", "-replay <file>", "-replay-profile <file>" and
+	// "-fixed-fps <N>" anywhere on the command line. Recording and replaying
+	// start in Begin().
+	static void Configure(const string &commandLine);
+
+	// called by the engine once the subsystems are up, before the first state
+	static void Begin();
+
+	// called by the engine for every input event, before it's dispatched
+	static void Record(const InputEvent &event);
+
+	// called by the engine at the start of every frame instead of Time::Step()
+	static void Step();
+
+private:
+	static const uint32_t Magic = 0x52495150; // "PQIR"
+	static const uint32_t Version = 1;
+
+	ofstream _file;
+	bool _recording;
+	vector<InputEvent> _pending;
+	bytestream _frame;
+
+	bytestream _replay;
+	bool _replaying;
+
+	string _recordFile;
+	string _replayFile;
+	string _profileFile;
+
+	void _recordFrame();
+	void _replayFrame();
+	void _finishReplay();
+};
@@ -28,10 +28,9 @@ RigidBody::RigidBody()
 }
 
 RigidBody::RigidBody(shared_ptr<Physics> physics,
-					 const vector<shared_ptr<PQB2Shape>> &shapes,
+					 const vector<shared_ptr<b2Shape>> &shapes,
 					 const vec2f &position,
 					 float angle,
-					 float scale,
 					 Type type,
 					 ContactMask self,
 					 ContactMask others)
@@ -50,40 +49,8 @@ RigidBody::RigidBody(shared_ptr<Physics> physics,
 	
 	_body = physics->world()->CreateBody(&bodyDef);
 
-	for(auto shape : shapes)
-	{
-		switch(shape->type)
-		{
-		case SHAPE_CIRCLE:
-			AddCircle(Physics::toMeters(((PQB2Circle*)shape.get())->center),
-				      Physics::toMeters(((PQB2Circle*)shape.get())->radius),
-				      scale, 0.1f, 0.2f, 0.0f);
-			break;
-
-		case SHAPE_POLYGON:
-			AddPolygon(((PQB2Polygon*)shape.get())->vertices,
-				       ((PQB2Polygon*)shape.get())->nVerts,
-				       scale * Physics::meterScaleFactor, 0.1f, 0.2f, 0.0f);
-
-			break;
-
-		case SHAPE_BOX:
-			AddBox(Physics::toMeters(((PQB2Box*)shape.get())->halfWidth),
-				   Physics::toMeters(((PQB2Box*)shape.get())->halfHeight),
-				   Physics::toMeters(((PQB2Box*)shape.get())->center),
-				   Physics::toMeters(((PQB2Box*)shape.get())->angle),
-				   scale, 0.1f, 0.2f, 0.0f);
-
-			break;
-
-		case SHAPE_EDGE:
-			AddEdge(Physics::toMeters(((PQB2Edge*)shape.get())->p1),
-				    Physics::toMeters(((PQB2Edge*)shape.get())->p2),
-				    scale, 0.1f, 0.2f, 0.0f);
-
-			break;
-		}
-	}
+	for(auto &shape : shapes)
+		AddShape(*shape, 0.1f, 0.2f, 0.0f);
 }
 
 RigidBody::RigidBody(shared_ptr<Physics> physics,
@@ -529,3 +496,21 @@ void RigidBody::AddEdge(const vec2f &p1,
 
 	_body->CreateFixture(&fixtureDef);
 }
+
+void RigidBody::AddShape(const b2Shape &shape,
+						 float density,
+						 float fric,
+						 float bounce)
+{
+	b2FixtureDef fixtureDef;
+	fixtureDef.shape = &shape;
+	fixtureDef.density = density;
+	fixtureDef.friction = fric;
+	fixtureDef.restitution = bounce;
+	fixtureDef.userData = nullptr;
+	fixtureDef.filter.categoryBits = (uint16_t)_self;
+	fixtureDef.filter.maskBits = (uint16_t)_others;
+	fixtureDef.isSensor = (_type == Type::Trigger);
+
+	_body->CreateFixture(&fixtureDef);
+}
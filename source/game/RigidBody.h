@@ -11,6 +11,7 @@
 
 class b2Body;
 class b2World;
+class b2Shape;
 class Physics;
 
 enum class ContactMask : uint16_t
@@ -52,11 +53,11 @@ public:
 	RigidBody();
 	RigidBody(RigidBody &&other);
 	RigidBody& operator=(RigidBody &&other);
+	// 'shapes' are in meters, see PQResImage::b2Shapes
 	RigidBody(shared_ptr<Physics> physics,
-			  const vector<shared_ptr<PQB2Shape>> &shapes,
+			  const vector<shared_ptr<b2Shape>> &shapes,
 			  const vec2f &position,
 			  float angle,
-			  float scale,
 			  Type type = Type::Static,
 			  ContactMask self = ContactMask::All,
 			  ContactMask others = ContactMask::All);
@@ -150,6 +151,11 @@ public:
 				 float fric = 0.2f,
 				 float bounce = 0);
 
+	void AddShape(const b2Shape &shape,
+				  float density = 0.1f,
+				  float fric = 0.2f,
+				  float bounce = 0);
+
 private:
 	b2Body *_body;
 	ContactMask _self;
@@ -4,8 +4,10 @@
 *--------------------------------------------------------------------------------------------*/
 
 #include "Shader.h"
+#include "Log.h"
 #include "Camera.h"
 #include "Texture.h"
+#include "Graphics.h"
 #include "utils.h"
 
 int AttribComponentCount(GLenum type)
@@ -119,6 +121,31 @@ GLenum AttribComponentType(GLenum type)
     return GL_NONE;
 }
 
+bool IsSamplerType(GLenum type)
+{
+	switch(type)
+	{
+	case GL_SAMPLER_2D:
+	case GL_SAMPLER_3D:
+	case GL_SAMPLER_CUBE:
+	case GL_SAMPLER_2D_ARRAY:
+	case GL_INT_SAMPLER_2D:
+	case GL_INT_SAMPLER_3D:
+	case GL_INT_SAMPLER_CUBE:
+	case GL_INT_SAMPLER_2D_ARRAY:
+	case GL_UNSIGNED_INT_SAMPLER_2D:
+	case GL_UNSIGNED_INT_SAMPLER_3D:
+	case GL_UNSIGNED_INT_SAMPLER_CUBE:
+	case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+	case GL_SAMPLER_2D_SHADOW:
+	case GL_SAMPLER_CUBE_SHADOW:
+	case GL_SAMPLER_2D_ARRAY_SHADOW:
+		return true;
+	}
+
+	return false;
+}
+
 /////////////////////
 
 weak_ptr<Shader> Shader::_activeShader;
@@ -126,11 +153,13 @@ weak_ptr<Shader> Shader::_activeShader;
 Shader::Shader()
 {
 	hProgram = -1;
+	attribMask = 0;
 }
 
 Shader::Shader(const string &vert, const string &frag)
 {
 	hProgram = -1;
+	attribMask = 0;
 	Load(vert, frag);
 }
 
@@ -147,7 +176,7 @@ bool Shader::Load(const string &vert, const string &frag)
 
 	if(vertexFile.empty())
 	{
-		Trace("Couldn't open vertex shader: " + vert);
+		Log(LogLevel::Error, LogCategory::Graphics, "Couldn't open vertex shader", vert);
 		return false;
 	}
 
@@ -155,7 +184,7 @@ bool Shader::Load(const string &vert, const string &frag)
 
 	if(fragmentFile.empty())
 	{
-		Trace("Couldn't open vertex shader: " + frag);
+		Log(LogLevel::Error, LogCategory::Graphics, "Couldn't open fragment shader", frag);
 		return false;
 	}
 
@@ -221,12 +250,17 @@ bool Shader::Load(const string &vert, const string &frag)
 		attrib.location = glGetAttribLocation(hProgram, name.c_str());
 		attrib.ctype = AttribComponentType(type);
 		attrib.ccount = AttribComponentCount(type);
+
+		if(attrib.location >= 0 && attrib.location < RenderState::MaxVertexAttribs)
+			attribMask |= 1u << attrib.location;
 		
 		int id = attribs.size();
 		attribs.push_back(attrib);
 		attribIDs.emplace(move(name), id);
 	}
 
+	int samplerCount = 0;
+
 	for(int i = 0; i < activeUniformCount; ++i)
 	{
 		GLsizei nameSize;
@@ -247,6 +281,8 @@ bool Shader::Load(const string &vert, const string &frag)
 		uniform.location = glGetUniformLocation(hProgram, name.c_str());
 		uniform.ctype = AttribComponentType(type);
 		uniform.ccount = AttribComponentCount(type);
+		uniform.unit = IsSamplerType(type) ? samplerCount++ : -1;
+		uniform.cached = false;
 
 		int id = uniforms.size();
 		uniforms.push_back(uniform);
@@ -261,9 +297,13 @@ void Shader::Unload()
 	Deactivate();
 
 	if(glIsProgram(hProgram))
+	{
+		Graphics::state().InvalidateProgram(hProgram);
 		glDeleteProgram(hProgram);
+	}
 	
 	hProgram = -1;
+	attribMask = 0;
 
 	attribs.clear();
 	uniforms.clear();
@@ -287,7 +327,7 @@ bool Shader::CheckShader(GLuint shader_id)
 
 			GLsizei nChars;
 			glGetShaderInfoLog(shader_id, errLength, &nChars, error.get());
-			Trace("Could not compile shader:", error.get());
+			Log(LogLevel::Error, LogCategory::Graphics, "Could not compile shader", error.get());
 		}
 	}
 
@@ -314,26 +354,40 @@ void Shader::_enableShader()
 {
 	assert(glIsProgram(hProgram));
 
-	glUseProgram(hProgram);
-
-	for(auto& att : this->attribs)
-		glEnableVertexAttribArray(att.location);
+	// attributes the previous shader used but this one doesn't are disabled here
+	Graphics::state().UseProgram(hProgram);
+	Graphics::state().EnableAttribs(attribMask);
 }
 
 void Shader::_disableShader()
 {
 	assert(glIsProgram(hProgram));
 
-	for(auto& att : this->attribs)
-		glDisableVertexAttribArray(att.location);
+	Graphics::state().EnableAttribs(0);
+	Graphics::state().UseProgram(0);
+}
+
+bool Shader::_changed(ShaderUniform &uniform, const void *value, size_t size)
+{
+	bool changed = !uniform.cached || memcmp(uniform.value, value, size) != 0;
+
+	if(changed)
+	{
+		memcpy(uniform.value, value, size);
+		uniform.cached = true;
+	}
 
-	glUseProgram(0);
+	Graphics::state().Record(StateChange::Uniform, changed);
+	return changed;
 }
 
 void Shader::SetActive()
 {
-	if(auto p = _activeShader.lock())
-		p->_disableShader();
+	if(_activeShader.lock().get() == this)
+	{
+		Graphics::state().Record(StateChange::Program, false);
+		return;
+	}
 
 	_enableShader();
 
@@ -356,11 +410,10 @@ shared_ptr<Shader> Shader::activeShader()
 
 void Shader::activeShader(const shared_ptr<Shader> &shader)
 {
-	if(auto p = _activeShader.lock())
-		p->_disableShader();
-
 	if(shader)
 		shader->_enableShader();
+	else if(auto p = _activeShader.lock())
+		p->_disableShader();
 	
 	_activeShader = shader;
 }
@@ -450,49 +503,56 @@ void Shader::SetUniform(int id, float value)
 {
 	if(id == -1) return;
 	auto uni = uniforms.begin() + id;
-	glUniform1f(uni->location, value);
+	if(_changed(*uni, &value, sizeof(value)))
+		glUniform1f(uni->location, value);
 }
 
 void Shader::SetUniform(int id, const vec2f &value)
 {
 	if(id == -1) return;
 	auto uni = uniforms.begin() + id;
-	glUniform2fv(uni->location, 1, (float*)&value);
+	if(_changed(*uni, &value, sizeof(value)))
+		glUniform2fv(uni->location, 1, (float*)&value);
 }
 
 void Shader::SetUniform(int id, const vec3f &value)
 {
 	if(id == -1) return;
 	auto uni = uniforms.begin() + id;
-	glUniform3fv(uni->location, 1, (float*)&value);
+	if(_changed(*uni, &value, sizeof(value)))
+		glUniform3fv(uni->location, 1, (float*)&value);
 }
 
 void Shader::SetUniform(int id, const vec4f &value)
 {
 	if(id == -1) return;
 	auto uni = uniforms.begin() + id;
-	glUniform4fv(uni->location, 1, (float*)&value);
+	if(_changed(*uni, &value, sizeof(value)))
+		glUniform4fv(uni->location, 1, (float*)&value);
 }
 
 void Shader::SetUniform(int id, const Color &value)
 {
 	if(id == -1) return;
 	auto uni = uniforms.begin() + id;
-	glUniform4fv(uni->location, 1, (float*)&value);
+	if(_changed(*uni, &value, sizeof(value)))
+		glUniform4fv(uni->location, 1, (float*)&value);
 }
 
 void Shader::SetUniform(int id, const mat3f &value)
 {
 	if(id == -1) return;
 	auto uni = uniforms.begin() + id;
-	glUniformMatrix3fv(uni->location, 1, GL_FALSE, (float*)&value);
+	if(_changed(*uni, &value, sizeof(value)))
+		glUniformMatrix3fv(uni->location, 1, GL_FALSE, (float*)&value);
 }
 
 void Shader::SetUniform(int id, const mat4f &value)
 {
 	if(id == -1) return;
 	auto uni = uniforms.begin() + id;
-	glUniformMatrix4fv(uni->location, 1, GL_FALSE, (float*)&value);
+	if(_changed(*uni, &value, sizeof(value)))
+		glUniformMatrix4fv(uni->location, 1, GL_FALSE, (float*)&value);
 }
 
 void Shader::SetUniform(int id, const Texture *texture)
@@ -501,30 +561,34 @@ void Shader::SetUniform(int id, const Texture *texture)
 
 	auto uni = uniforms.begin() + id;
 
-	int textureUnit = id;
-	int samplerSlot = uni->location;
-	
-	glActiveTexture(GL_TEXTURE0 + textureUnit);
-	glBindTexture(GL_TEXTURE_2D, texture? texture->textureID() : 0);
-	glUniform1i(samplerSlot, textureUnit);
+	if(uni->unit < 0 || uni->unit >= RenderState::MaxTextureUnits)
+		return;
+
+	Graphics::state().BindTexture(uni->unit, texture ? texture->textureID() : 0);
+
+	// the sampler only has to be pointed at its unit once
+	GLint unit = uni->unit;
+	if(_changed(*uni, &unit, sizeof(unit)))
+		glUniform1i(uni->location, unit);
 }
 
 void Shader::SetVertexBuffer(int id, DrawBuffer *buffer)
+{
+	SetVertexBuffer(id, buffer->bufferID(), 0, 0);
+}
+
+void Shader::SetVertexBuffer(int id, uint32_t bufferID, uint32_t stride, uint32_t offset)
 {
 	if(id == -1)
 		return;
 	
 	auto att = attribs.begin() + id;
 
-	int location = att->location;
-
-	glBindBuffer(GL_ARRAY_BUFFER, buffer->bufferID());
-	glVertexAttribPointer(location, att->ccount, att->ctype, GL_FALSE, 0, 0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	Graphics::state().AttribPointer(att->location, bufferID, att->ccount, att->ctype, stride, offset);
 }
 
 void Shader::SetIndexBuffer(DrawBuffer *buffer)
 {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer ? buffer->bufferID() : 0);
+	Graphics::state().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer ? buffer->bufferID() : 0);
 }
 
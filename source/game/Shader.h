@@ -33,6 +33,9 @@ public:
 		GLint location;
 		GLenum ctype;
 		GLint ccount;
+		GLint unit;       // texture unit for samplers, -1 otherwise
+		bool cached;
+		float value[16];  // last value sent to GL
 	};
 
 	Shader();
@@ -69,6 +72,7 @@ public:
 	void SetUniform(int id, const mat4f &value);
 	void SetUniform(int id, const Texture *texture);
 	void SetVertexBuffer(int id, DrawBuffer *buffer);
+	void SetVertexBuffer(int id, uint32_t bufferID, uint32_t stride, uint32_t offset);
 	void SetIndexBuffer(DrawBuffer *buffer);
 	
 	static shared_ptr<Shader> activeShader();
@@ -81,11 +85,13 @@ protected:
 
 	vector<VertexAttrib> attribs;
 	vector<ShaderUniform> uniforms;
+	uint32_t attribMask;
 	unordered_map<string, int> attribIDs;
 	unordered_map<string, int> uniformIDs;
 	
 	void _enableShader();
 	void _disableShader();
+	bool _changed(ShaderUniform &uniform, const void *value, size_t size);
 
 	bool CheckShader(GLuint shader_id);
 	bool ValidateProgram(GLuint hProgram);
@@ -6,30 +6,18 @@
 #include "Sound.h"
 #include "Engine.h"
 #include "Audio.h"
+#include "Log.h"
 #include <AL/al.h>
 #include <AL/alc.h>
 
 Sound::Sound()
 {
-	blocking = false;
-	opened = false;
-	gain = 1.0f;
-
-	buffer = 0;
-	source = 0;
-	_length = 0;
+	_init();
 }
 
 Sound::Sound(const string &filename)
 {
-	blocking = false;
-	opened = false;
-	gain = 1.0f;
-
-	buffer = 0;
-	source = 0;
-	_length = 0;
-
+	_init();
 	Open(filename);
 }
 
@@ -38,193 +26,225 @@ Sound::~Sound()
 	Close();
 }
 
-bool Sound::Open(const string &filename)
+void Sound::_init()
 {
-	if(!wave.Open(filename.c_str()))
-	{
-		Trace("could not open file", filename);
-		return false;
-	}
-
-	auto lk = Audio::GetLock();
-
-	ALenum format;
-	ALfloat sourceOri[] = {0.0, 0.0, 1.0, 0.0, 1.0, 0.0};
-
-	// clear error before loading sounds
-	alGetError();
+	blocking = false;
+	looping = false;
+	gain = 1.0f;
+	_pitch = 1.0f;
+	category = SoundCategory::Effect;
+	priority = 0;
+	polyphony = 4;
+}
 
-// create a buffer
-	alGenBuffers(1, &buffer);
+template<class F>
+void Sound::_forEachSource(F fx) const
+{
+	VoicePool &voices = Audio::voices();
 
-	if(wave.Channels() == 2 && wave.Bitrate() == 8)
-	{
-		format = AL_FORMAT_STEREO8;
-	}
-	else if(wave.Channels() == 2 && wave.Bitrate() == 16)
-	{
-		format = AL_FORMAT_STEREO16;
-	}
-	else if(wave.Channels() == 1 && wave.Bitrate() == 8)
-	{
-		format = AL_FORMAT_MONO8;
-	}
-	else if(wave.Channels() == 1 && wave.Bitrate() == 16)
-	{
-		format = AL_FORMAT_MONO16;
-	}
-	else
+	for(auto &handle : _voices)
 	{
-		Trace("Unsupported Audio Format: ", filename);
-		return false;
+		if(ALuint source = voices.source(handle))
+			fx(source);
 	}
+}
 
-	// fill the buffer with data
-	alBufferData(buffer, format, wave.Data(), wave.DataSize(), wave.Frequency());
-	
-	// generate an audio source
-	alGenSources(1, &source);
-	
-	// attach the buffer to the source
-	alSourcei(source, AL_BUFFER, buffer);
+// forget voices that were stolen or have finished playing
+void Sound::_prune()
+{
+	VoicePool &voices = Audio::voices();
 
-	// set source position, velocity and orientation
-	alSource3f(source, AL_POSITION, 0.0, 0.0, 0.0f);
-	alSource3f(source, AL_VELOCITY, 0.0, 0.0, 0.0);
-	alSourcefv(source, AL_DIRECTION, sourceOri);
+	for(auto it = _voices.begin(); it != _voices.end(); )
+	{
+		ALuint source = voices.source(*it);
+		ALint state = AL_STOPPED;
 
-	// disable the affect of distance on volume
-	alSourcef(source, AL_ROLLOFF_FACTOR, 0.0);
-	alSourcei(source, AL_SOURCE_RELATIVE, AL_TRUE);
+		if(source)
+			alGetSourcei(source, AL_SOURCE_STATE, &state);
 
-	float bytesPerFrame = (float)(wave.Channels() * wave.Bitrate() / 8);
-	float bytesPerSecond = wave.Frequency() * bytesPerFrame;
-	_length = (float)wave.DataSize() / bytesPerSecond;
+		if(state == AL_PLAYING || state == AL_PAUSED)
+			++it;
+		else
+			it = _voices.erase(it);
+	}
+}
 
-	opened = true;
+bool Sound::Open(const string &filename)
+{
+	Close();
 
-	return true;
+	_buffer = Audio::voices().LoadBuffer(filename);
+	return _buffer != nullptr;
 }
 
 void Sound::Close()
 {
 	auto lk = Audio::GetLock();
 
-	if(opened == false)
+	for(auto &handle : _voices)
+		Audio::voices().Release(handle);
+
+	_voices.clear();
+	_buffer.reset();
+}
+
+void Sound::Play()
+{
+	if(!_buffer)
 		return;
 
-	if(alIsSource(source))
+	// compressed files finish loading in the background after Open()
+	if(_buffer->failed())
 	{
-		alSourceStop(source);
-		alSourcei(source, AL_BUFFER, 0);
-		alDeleteSources(1, &source);
-		source = 0;
+		Log(LogLevel::Error, LogCategory::Audio, "can't play a sound that failed to load");
+		_buffer.reset();
+		return;
 	}
 
-	wave.Close();
-	
-	if(alIsBuffer(buffer))
+	auto lk = Audio::GetLock();
+
+	_prune();
+
+	// a paused sound continues on the voices it holds
+	bool resumed = false;
+
+	_forEachSource([&](ALuint source)
 	{
-		alDeleteBuffers(1, &buffer);
-		buffer = 0;
-	}
+		ALint state;
+		alGetSourcei(source, AL_SOURCE_STATE, &state);
 
-	opened = false;
-	_length = 0;
-}
+		if(state == AL_PAUSED)
+		{
+			alSourcePlay(source);
+			resumed = true;
+		}
+	});
 
-void Sound::Play()
-{
-	auto lk = Audio::GetLock();
+	if(resumed)
+		return;
 
-	ALenum state;
-	alGetSourcei(source, AL_SOURCE_STATE, &state);
+	int maxVoices = looping ? 1 : polyphony;
 
-	// stop the sound if it's already playing
-	if(state == AL_PLAYING && !blocking)
+	if((int)_voices.size() >= maxVoices)
 	{
+		if(blocking)
+			return;
+
+		// restart the oldest voice instead of taking another one
+		VoiceHandle handle = _voices.front();
+		_voices.erase(_voices.begin());
+
+		ALuint source = Audio::voices().source(handle);
 		alSourceStop(source);
+		alSourcePlay(source);
+
+		_voices.push_back(handle);
+		return;
+	}
+
+	VoiceHandle handle = Audio::voices().Acquire(_buffer, category, priority);
+
+	if(ALuint source = Audio::voices().source(handle))
+	{
+		alSourcef(source, AL_GAIN, gain);
+		alSourcef(source, AL_PITCH, _pitch);
+		alSourcei(source, AL_LOOPING, looping ? AL_TRUE : AL_FALSE);
+		alSourcePlay(source);
+
+		_voices.push_back(handle);
 	}
-	
-	// play the sound
-	alSourcePlay(source);
 }
 
 void Sound::Stop()
 {
 	auto lk = Audio::GetLock();
-	if(source) alSourceStop(source);
+
+	for(auto &handle : _voices)
+		Audio::voices().Release(handle);
+
+	_voices.clear();
 }
 
 void Sound::Pause()
 {
 	auto lk = Audio::GetLock();
-	if(source) alSourcePause(source);
+	_forEachSource([](ALuint source){ alSourcePause(source); });
 }
 
 bool Sound::IsPlaying()
 {
 	auto lk = Audio::GetLock();
 
-	ALenum state;
-	alGetSourcei(source, AL_SOURCE_STATE, &state);
-	return (state == AL_PLAYING);
+	bool playing = false;
+
+	_forEachSource([&](ALuint source)
+	{
+		ALint state;
+		alGetSourcei(source, AL_SOURCE_STATE, &state);
+		playing = playing || state == AL_PLAYING;
+	});
+
+	return playing;
 }
 
 bool Sound::IsPaused()
 {
 	auto lk = Audio::GetLock();
 
-	ALenum state;
-	alGetSourcei(source, AL_SOURCE_STATE, &state);
-	return (state == AL_PAUSED);
+	bool paused = false;
+
+	_forEachSource([&](ALuint source)
+	{
+		ALint state;
+		alGetSourcei(source, AL_SOURCE_STATE, &state);
+		paused = paused || state == AL_PAUSED;
+	});
+
+	return paused;
 }
 
 bool Sound::IsStopped()
 {
-	auto lk = Audio::GetLock();
-
-	ALenum state;
-	alGetSourcei(source, AL_SOURCE_STATE, &state);
-	return (state == AL_INITIAL || state == AL_STOPPED);
+	return !IsPlaying() && !IsPaused();
 }
 
 bool Sound::IsOpen()
 {
-	return opened;
+	return _buffer && !_buffer->failed();
 }
 
 float Sound::length()
 {
-	return _length;
+	return _buffer && _buffer->ready() ? _buffer->length : 0.0f;
 }
 
 void Sound::pitch(float setPitch)
 {
 	auto lk = Audio::GetLock();
-	if(source) alSourcef(source, AL_PITCH, setPitch);
+
+	_pitch = setPitch;
+	_forEachSource([&](ALuint source){ alSourcef(source, AL_PITCH, _pitch); });
 }
 
 float Sound::pitch() const
 {
-	float ret = 0;
-	
-	auto lk = Audio::GetLock();
-	if(source) alGetSourcef(source, AL_PITCH, &ret);
-
-	return ret;
+	return _pitch;
 }
 
 void Sound::SetLoop(bool loop)
 {
 	auto lk = Audio::GetLock();
-	if(source) alSourcei(source, AL_LOOPING, loop ? AL_TRUE : AL_FALSE);
+
+	looping = loop;
+	_forEachSource([&](ALuint source){ alSourcei(source, AL_LOOPING, looping ? AL_TRUE : AL_FALSE); });
 }
 
 void Sound::SetGain(float gain)
 {
 	auto lk = Audio::GetLock();
-	alSourcef(source, AL_GAIN, gain);
+
+	this->gain = gain;
+	_forEachSource([&](ALuint source){ alSourcef(source, AL_GAIN, gain); });
 }
 
 void Sound::SetBlocking(bool enable)
@@ -232,30 +252,45 @@ void Sound::SetBlocking(bool enable)
 	blocking = enable;
 }
 
+void Sound::SetCategory(SoundCategory category)
+{
+	this->category = category;
+}
+
+void Sound::SetPriority(int priority)
+{
+	this->priority = priority;
+}
+
+void Sound::SetPolyphony(int maxVoices)
+{
+	polyphony = max(maxVoices, 1);
+}
+
 void Sound::OnInitialize()
 {
 	auto lk = Audio::GetLock();
 
-	if(opened)
+	_forEachSource([](ALuint source)
 	{
-		ALenum state;
+		ALint state;
 		alGetSourcei(source, AL_SOURCE_STATE, &state);
 
 		if(state == AL_PAUSED)
 			alSourcePlay(source);
-	}
+	});
 }
 
 void Sound::OnDestroy()
 {
 	auto lk = Audio::GetLock();
 
-	if(opened)
+	_forEachSource([](ALuint source)
 	{
-		ALenum state;
+		ALint state;
 		alGetSourcei(source, AL_SOURCE_STATE, &state);
 
 		if(state == AL_PLAYING)
 			alSourcePause(source);
-	}
+	});
 }
@@ -6,11 +6,9 @@
 #pragma once
 
 #include "Object.h"
-#include "Wave.h"
+#include "VoicePool.h"
 using namespace std;
 
-typedef unsigned int ALuint;
-
 class Sound : public Object
 {
 public:
@@ -18,6 +16,8 @@ public:
 	Sound(const string &filename);
 	~Sound();
 
+	// compressed files are decoded in the background, if that fails the
+	// error is logged and IsOpen() becomes false
 	bool Open(const string &filename);
 	void Close();
 
@@ -38,16 +38,26 @@ public:
 	void SetGain(float gain = 1.0f);
 	void SetBlocking(bool enable = false);
 
+	// voice allocation, see VoicePool
+	void SetCategory(SoundCategory category);
+	void SetPriority(int priority);
+	void SetPolyphony(int maxVoices);
+
 private:
-	Wave wave;
-	bool opened;
+	shared_ptr<SoundBuffer> _buffer;
+	vector<VoiceHandle> _voices; // oldest first
 	bool blocking;
+	bool looping;
 	float gain;
+	float _pitch;
+	SoundCategory category;
+	int priority;
+	int polyphony;
 
 	virtual void OnDestroy();
 	virtual void OnInitialize();
 
-	ALuint buffer;
-	ALuint source;
-	float _length;
+	void _init();
+	void _prune();
+	template<class F> void _forEachSource(F fx) const;
 };
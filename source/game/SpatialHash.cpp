@@ -0,0 +1,152 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "SpatialHash.h"
+#include <algorithm>
+#include <cmath>
+
+static void RemoveHandle(vector<uint32_t> &handles, uint32_t handle)
+{
+	auto it = find(handles.begin(), handles.end(), handle);
+
+	if(it != handles.end())
+	{
+		*it = handles.back();
+		handles.pop_back();
+	}
+}
+
+SpatialHash::SpatialHash(float cellSize)
+	: _rcpCellSize(1.0f / cellSize), _stamp(0), _count(0)
+{
+}
+
+uint32_t SpatialHash::Insert(Object *obj, const Rect &rect)
+{
+	uint32_t handle;
+
+	if(!_free.empty())
+	{
+		handle = _free.back();
+		_free.pop_back();
+	}
+	else
+	{
+		handle = (uint32_t)_entries.size();
+		_entries.push_back(Entry());
+	}
+
+	Entry &entry = _entries[handle];
+	entry.obj = obj;
+	entry.rect = rect;
+	entry.stamp = _stamp;
+
+	_link(handle);
+	++_count;
+
+	return handle;
+}
+
+void SpatialHash::Move(uint32_t handle, const Rect &rect)
+{
+	Entry &entry = _entries[handle];
+	entry.rect = rect;
+
+	int x0, y0, x1, y1;
+	_cells(rect, x0, y0, x1, y1);
+
+	// most moves stay inside the same cells
+	if(x0 == entry.x0 && y0 == entry.y0 && x1 == entry.x1 && y1 == entry.y1)
+		return;
+
+	_unlink(handle);
+	_link(handle);
+}
+
+void SpatialHash::Remove(uint32_t handle)
+{
+	_unlink(handle);
+
+	_entries[handle].obj = nullptr;
+	_free.push_back(handle);
+	--_count;
+}
+
+void SpatialHash::Clear()
+{
+	_entries.clear();
+	_free.clear();
+	_large.clear();
+	_grid.clear();
+	_count = 0;
+}
+
+size_t SpatialHash::size() const
+{
+	return _count;
+}
+
+void SpatialHash::_cells(const Rect &rect, int &x0, int &y0, int &x1, int &y1) const
+{
+	x0 = (int)floor(rect.x * _rcpCellSize);
+	y0 = (int)floor(rect.y * _rcpCellSize);
+	x1 = (int)floor((rect.x + rect.w) * _rcpCellSize);
+	y1 = (int)floor((rect.y + rect.h) * _rcpCellSize);
+}
+
+void SpatialHash::_link(uint32_t handle)
+{
+	Entry &entry = _entries[handle];
+	_cells(entry.rect, entry.x0, entry.y0, entry.x1, entry.y1);
+
+	entry.large = entry.x1 - entry.x0 >= MaxSpan || entry.y1 - entry.y0 >= MaxSpan;
+
+	if(entry.large)
+	{
+		_large.push_back(handle);
+		return;
+	}
+
+	for(int y = entry.y0; y <= entry.y1; ++y)
+	{
+		for(int x = entry.x0; x <= entry.x1; ++x)
+			_grid[_key(x, y)].push_back(handle);
+	}
+}
+
+void SpatialHash::_unlink(uint32_t handle)
+{
+	Entry &entry = _entries[handle];
+
+	if(entry.large)
+	{
+		RemoveHandle(_large, handle);
+		return;
+	}
+
+	for(int y = entry.y0; y <= entry.y1; ++y)
+	{
+		for(int x = entry.x0; x <= entry.x1; ++x)
+		{
+			auto it = _grid.find(_key(x, y));
+
+			if(it == _grid.end())
+				continue;
+
+			RemoveHandle(it->second, handle);
+
+			if(it->second.empty())
+				_grid.erase(it);
+		}
+	}
+}
+
+void SpatialHash::_resetStamps()
+{
+	for(auto &entry : _entries)
+		entry.stamp = 0;
+
+	_stamp = 1;
+}
@@ -0,0 +1,120 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "Math.h"
+
+using namespace std;
+
+class Object;
+
+// Uniform grid over world space, keyed by cell coordinate so empty space costs
+// nothing. Every entry is listed in each cell its rect touches, and a query
+// only visits the cells under the query rect, so its cost follows what is
+// inside the rect rather than the number of entries.
+class SpatialHash
+{
+public:
+	static const uint32_t None = 0xFFFFFFFF;
+
+	SpatialHash(float cellSize = 512.0f);
+	SpatialHash(const SpatialHash&) = delete;
+	SpatialHash &operator=(const SpatialHash&) = delete;
+
+	// returns a handle for Move() and Remove()
+	uint32_t Insert(Object *obj, const Rect &rect);
+	void Move(uint32_t handle, const Rect &rect);
+	void Remove(uint32_t handle);
+	void Clear();
+
+	// calls fx(Object*) once for every entry whose rect overlaps 'rect'
+	template<class FN>
+	void Query(const Rect &rect, FN &&fx)
+	{
+		if(++_stamp == 0)
+			_resetStamps();
+
+		for(uint32_t handle : _large)
+			_visit(handle, rect, fx);
+
+		int x0, y0, x1, y1;
+		_cells(rect, x0, y0, x1, y1);
+
+		for(int y = y0; y <= y1; ++y)
+		{
+			for(int x = x0; x <= x1; ++x)
+			{
+				auto it = _grid.find(_key(x, y));
+
+				if(it == _grid.end())
+					continue;
+
+				for(uint32_t handle : it->second)
+					_visit(handle, rect, fx);
+			}
+		}
+	}
+
+	// calls fx(Object*) for every entry
+	template<class FN>
+	void ForEach(FN &&fx)
+	{
+		for(auto &entry : _entries)
+		{
+			if(entry.obj)
+				fx(entry.obj);
+		}
+	}
+
+	size_t size() const;
+
+private:
+	// rects spanning more cells than this in either direction are kept out of
+	// the grid and tested on every query instead
+	static const int MaxSpan = 32;
+
+	struct Entry
+	{
+		Object *obj;
+		Rect rect;
+		int x0, y0, x1, y1;
+		bool large;
+		uint32_t stamp;
+	};
+
+	vector<Entry> _entries;
+	vector<uint32_t> _free;
+	vector<uint32_t> _large;
+	unordered_map<uint64_t, vector<uint32_t>> _grid;
+	float _rcpCellSize;
+	uint32_t _stamp;
+	size_t _count;
+
+	static uint64_t _key(int x, int y) {
+		return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+	}
+
+	template<class FN>
+	void _visit(uint32_t handle, const Rect &rect, FN &fx)
+	{
+		Entry &entry = _entries[handle];
+
+		if(entry.stamp != _stamp)
+		{
+			entry.stamp = _stamp;
+
+			if(entry.rect.Intersects(rect))
+				fx(entry.obj);
+		}
+	}
+
+	void _cells(const Rect &rect, int &x0, int &y0, int &x1, int &y1) const;
+	void _link(uint32_t handle);
+	void _unlink(uint32_t handle);
+	void _resetStamps();
+};
@@ -6,6 +6,7 @@
 #include "Sprite.h"
 #include "Engine.h"
 #include "Graphics.h"
+#include "MathBatch.h"
 #include <fstream>
 #include <memory>
 using namespace std;
@@ -36,9 +37,13 @@ Sprite::Sprite(const Sprite &other)
 	cosAng = other.cosAng;
 	sinAng = other.sinAng;
 	_filename = other._filename;
+	aPositionID = other.aPositionID;
+	aTexCoordID = other.aTexCoordID;
+	uMainTexID = other.uMainTexID;
+	uMtxMvpID = other.uMtxMvpID;
 
-	vertexBuffer.SetData(nullptr, 4 * sizeof(vec2f), DrawBuffer::Type::VertexData, true);
-	texcoordBuffer.SetData(nullptr, 4 * sizeof(vec2f), DrawBuffer::Type::VertexData, true);
+	for(int i = 0; i < 4; ++i)
+		_staticQuad[i] = other._staticQuad[i];
 }
 
 Sprite::Sprite(const shared_ptr<Texture> &texture)
@@ -72,7 +77,8 @@ void Sprite::_init()
 {
 	category = 0xFFFFFFFF;
 
-	texture = make_shared<Texture>();
+	// shared placeholder until a texture is assigned or opened
+	texture = Graphics::emptyTexture();
 	_clipBorder.Set(0, 0, 0, 0);
 	pos.set(0, 0);
 	nRows = 1;
@@ -93,9 +99,6 @@ void Sprite::_init()
 	aTexCoordID = -1;
 	uMainTexID = -1;
 	uMtxMvpID = -1;
-
-	vertexBuffer.SetData(nullptr, 4 * sizeof(vec2f), DrawBuffer::Type::VertexData, true);
-	texcoordBuffer.SetData(nullptr, 4 * sizeof(vec2f), DrawBuffer::Type::VertexData, true);
 }
 
 Sprite::~Sprite()
@@ -106,7 +109,9 @@ Sprite::~Sprite()
 bool Sprite::Open(const char *filename)
 {
 	_filename = filename;
+	texture = make_shared<Texture>();
 	visible = texture->Open(_filename);
+	_boundsChanged();
 
 	if(visible)
 	{
@@ -120,21 +125,27 @@ bool Sprite::Open(const char *filename)
 void Sprite::Close()
 {
 	_init();
+	_boundsChanged();
 }
 
 void Sprite::Draw()
 {
-	if(!Camera::activeCamera() || !visible || !shader || vertexBuffer.empty())
+	if(!Camera::activeCamera() || !visible || !shader)
 		return;
 
-	shader->SetActive();
-	shader->SetUniform(uMainTexID, texture.get());
-	shader->SetUniform(uMtxMvpID, Camera::activeCamera()->matrix());
+	StreamRange range;
+	SpriteVertex *quad;
 
 	if(_is_static)
 	{
 		if(!Camera::activeCamera()->viewRect.Intersects(_staticRect))
 			return;
+
+		quad = (SpriteVertex*)Graphics::stream().Map(sizeof(_staticQuad), sizeof(SpriteVertex), range);
+		if(!quad)
+			return;
+
+		memcpy(quad, _staticQuad, sizeof(_staticQuad));
 	}
 	else
 	{
@@ -150,12 +161,14 @@ void Sprite::Draw()
 
 		vec2f verts[4] =
 		{
-			vec2f(xf, -hw + _clipBorder.x, -hh + _clipBorder.y),
-			vec2f(xf, -hw + _clipBorder.x,  hh - _clipBorder.h),
-			vec2f(xf,  hw - _clipBorder.w, -hh + _clipBorder.y),
-			vec2f(xf,  hw - _clipBorder.w,  hh - _clipBorder.h),
+			vec2f(-hw + _clipBorder.x, -hh + _clipBorder.y),
+			vec2f(-hw + _clipBorder.x,  hh - _clipBorder.h),
+			vec2f( hw - _clipBorder.w, -hh + _clipBorder.y),
+			vec2f( hw - _clipBorder.w,  hh - _clipBorder.h),
 		};
 
+		math::TransformPoints(xf, verts, verts, 4);
+
 		Rect rc;
 
 		rc.x = Min4(verts[0].x, verts[1].x, verts[2].x, verts[3].x);
@@ -185,41 +198,78 @@ void Sprite::Draw()
 		texcoords[3].x = texcoords[2].x;
 		texcoords[3].y = texcoords[1].y;
 
-		vertexBuffer.UpdateData(verts, 0, 4 * sizeof(vec2f));
-		texcoordBuffer.UpdateData(texcoords, 0, 4 * sizeof(vec2f));
+		quad = (SpriteVertex*)Graphics::stream().Map(4 * sizeof(SpriteVertex), sizeof(SpriteVertex), range);
+		if(!quad)
+			return;
+
+		for(int i = 0; i < 4; ++i)
+		{
+			quad[i].position = verts[i];
+			quad[i].texcoord = texcoords[i];
+		}
 	}
 
-	shader->SetVertexBuffer(aPositionID, &vertexBuffer);
-	shader->SetVertexBuffer(aTexCoordID, &texcoordBuffer);
+	Graphics::stream().Unmap();
+
+	shader->SetActive();
+	shader->SetUniform(uMainTexID, texture.get());
+	shader->SetUniform(uMtxMvpID, Camera::activeCamera()->matrix());
+
+	// the pointers stay at the start of the buffer so consecutive sprites
+	// don't touch them, the quad is selected by its first vertex instead
+	shader->SetVertexBuffer(aPositionID, range.buffer, sizeof(SpriteVertex), 0);
+	shader->SetVertexBuffer(aTexCoordID, range.buffer, sizeof(SpriteVertex), sizeof(vec2f));
 	
-	Graphics::DrawArray(0, 4, DrawMode::TriangleStrip);
+	Graphics::DrawArray(range.offset / sizeof(SpriteVertex), 4, DrawMode::TriangleStrip);
+}
+
+BoundsType Sprite::GetBounds(Rect &bounds)
+{
+	// category 0 is never submitted, not worth keeping in the hash
+	if(!texture || !category)
+		return BoundsType::None;
+
+	bounds = rect();
+
+	return BoundsType::Culled;
+}
+
+void Sprite::_boundsChanged()
+{
+	// a static rect only changes in SetStatic(). Sprites that are never
+	// submitted are read once more to drop them from the hash, then left alone.
+	if(!_is_static && (category || culled()))
+		BoundsChanged();
 }
 
 void Sprite::SetX(float X)
 {
-	pos.x = X;
+	SetPos(vec2f(X, pos.y));
 }
 
 void Sprite::SetY(float Y)
 {
-	pos.y = Y;
+	SetPos(vec2f(pos.x, Y));
 }
 
 void Sprite::SetPos(int X, int Y)
 {
-	pos.x = (float)X;
-	pos.y = (float)Y;
+	SetPos(vec2f((float)X, (float)Y));
 }
 
 void Sprite::SetPos(float X, float Y)
 {
-	pos.x = X;
-	pos.y = Y;
+	SetPos(vec2f(X, Y));
 }
 
 void Sprite::SetPos(const vec2f &pos)
 {
+	// most movers set their position every frame, moving or not
+	if(this->pos == pos)
+		return;
+
 	this->pos = pos;
+	_boundsChanged();
 }
 
 float Sprite::GetX()
@@ -274,12 +324,14 @@ Rect Sprite::rect()
 
 		vec2f verts[4] =
 		{
-			vec2f(xf, -hw + _clipBorder.x, -hh + _clipBorder.y),
-			vec2f(xf, -hw + _clipBorder.x,  hh - _clipBorder.h),
-			vec2f(xf,  hw - _clipBorder.w, -hh + _clipBorder.y),
-			vec2f(xf,  hw - _clipBorder.w,  hh - _clipBorder.h),
+			vec2f(-hw + _clipBorder.x, -hh + _clipBorder.y),
+			vec2f(-hw + _clipBorder.x,  hh - _clipBorder.h),
+			vec2f( hw - _clipBorder.w, -hh + _clipBorder.y),
+			vec2f( hw - _clipBorder.w,  hh - _clipBorder.h),
 		};
 
+		math::TransformPoints(xf, verts, verts, 4);
+
 		ret.x = Min4(verts[0].x, verts[1].x, verts[2].x, verts[3].x);
 		ret.y = Min4(verts[0].y, verts[1].y, verts[2].y, verts[3].y);
 		ret.w = Max4(verts[0].x, verts[1].x, verts[2].x, verts[3].x) + 0.5f - ret.x;
@@ -297,6 +349,7 @@ Rect Sprite::clipBorder()
 void Sprite::clipBorder(const Rect &setClipBorder)
 {
 	_clipBorder = setClipBorder;
+	_boundsChanged();
 }
 
 const Path &Sprite::filename() const
@@ -330,14 +383,19 @@ void Sprite::Rotate(float degrees)
 	float radAng = RADIANS(angle);
 	cosAng = cos(radAng);
 	sinAng = sin(radAng);
+	_boundsChanged();
 }
 
 void Sprite::SetAngle(float degrees)
 {
+	if(angle == degrees)
+		return;
+
 	angle = degrees;
 	float radAng = RADIANS(angle);
 	cosAng = cos(radAng);
 	sinAng = sin(radAng);
+	_boundsChanged();
 }
 
 float Sprite::GetAngle()
@@ -347,7 +405,11 @@ float Sprite::GetAngle()
 
 void Sprite::SetScale(float multiplier)
 {
+	if(scale == multiplier)
+		return;
+
 	scale = multiplier;
+	_boundsChanged();
 }
 
 float Sprite::GetScale()
@@ -399,29 +461,27 @@ void Sprite::SetStatic(bool is_static)
 		staticTexCoords[3].x = staticTexCoords[2].x;
 		staticTexCoords[3].y = staticTexCoords[1].y;
 
-		vertexBuffer.SetData(staticVerts, 4 * sizeof(vec2f), DrawBuffer::Type::VertexData);
-		texcoordBuffer.SetData(staticTexCoords, 4 * sizeof(vec2f), DrawBuffer::Type::VertexData);
-	}
-	else
-	{
-		if(_is_static)
+		for(int i = 0; i < 4; ++i)
 		{
-			vertexBuffer.SetData(nullptr, 4 * sizeof(vec2f), DrawBuffer::Type::VertexData, true);
-			texcoordBuffer.SetData(nullptr, 4 * sizeof(vec2f), DrawBuffer::Type::VertexData, true);
+			_staticQuad[i].position = staticVerts[i];
+			_staticQuad[i].texcoord = staticTexCoords[i];
 		}
 	}
 
 	_is_static = is_static;
+	BoundsChanged();
 }
 
 void Sprite::SetNumRows(int rows)
 {
 	nRows = rows;
+	_boundsChanged();
 }
 
 void Sprite::SetNumCols(int columns)
 {
 	nColumns = columns;
+	_boundsChanged();
 }
 
 int Sprite::GetNumRows()
@@ -484,6 +544,7 @@ shared_ptr<Shader> Sprite::GetShader()
 void Sprite::SetTexture(const shared_ptr<Texture> &texture)
 {
 	this->texture = texture;
+	_boundsChanged();
 }
 
 shared_ptr<Texture> Sprite::GetTexture()
@@ -20,6 +20,12 @@
 
 using namespace std;
 
+struct SpriteVertex
+{
+	vec2f position;
+	vec2f texcoord;
+};
+
 class Sprite : public Object
 {
 	friend class Engine;
@@ -80,10 +86,12 @@ public:
 	void clipBorder(const Rect &setClipBorder);
 
 	virtual void Draw() override;
+	virtual BoundsType GetBounds(Rect &bounds) override;
 
 private:
 	
 	void _init();
+	void _boundsChanged();
 
 	shared_ptr<Texture> texture;
 	shared_ptr<Shader> shader;
@@ -92,8 +100,7 @@ private:
 	bool _is_static;
 	
 	Rect _staticRect;
-	DrawBuffer vertexBuffer;
-	DrawBuffer texcoordBuffer;
+	SpriteVertex _staticQuad[4];
 	Rect _clipBorder;
 	vec2f pos;
 	float angle;
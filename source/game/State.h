@@ -13,6 +13,7 @@
 #include "Object.h"
 #include "RenderQueue.h"
 #include "Physics.h"
+#include "EngineContext.h"
 
 using namespace std;
 
@@ -20,15 +21,23 @@ class State : public Object
 {
 public:
 	shared_ptr<Physics> physics;
+	ObjectRegistry registry;
+	shared_ptr<Arena> arena; // optional, used by Object::New
+	EngineContext *context;  // the one the state was created in
 
-	State() : physics(make_shared<Physics>()) {}
-	virtual ~State(){}
+	// attached to its registry by the Engine when it is set or pushed, once
+	// the object is fully constructed
+	State() : physics(make_shared<Physics>()), context(EngineContext::current()) {}
+
+	virtual ~State() {
+		registry.Detach(this);
+	}
 
 	virtual void StateDraw()
 	{
 		RenderQueue::Clear();
 		
-		SubmitDrawCalls_R(0xFFFFFFFF);
+		registry.SubmitDrawCalls(0xFFFFFFFF);
 
 		RenderQueue::Sort();
 		RenderQueue::Execute();
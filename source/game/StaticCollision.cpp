@@ -0,0 +1,120 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "StaticCollision.h"
+#include "Physics.h"
+#include <Box2D.h>
+#include <cmath>
+
+static void TransformPolygon(b2PolygonShape &polygon, const b2Transform &xf)
+{
+	for(int i = 0; i < polygon.m_vertexCount; ++i)
+	{
+		polygon.m_vertices[i] = b2Mul(xf, polygon.m_vertices[i]);
+		polygon.m_normals[i] = b2Mul(xf.q, polygon.m_normals[i]);
+	}
+
+	polygon.m_centroid = b2Mul(xf, polygon.m_centroid);
+}
+
+StaticCollision::StaticCollision(shared_ptr<Physics> physics, float chunkSize)
+	: _physics(physics), _chunkSize(chunkSize), _fixtureCount(0)
+{
+}
+
+RigidBody *StaticCollision::_chunk(const vec2f &position, vec2f &origin)
+{
+	int cx = (int)floor(position.x / _chunkSize);
+	int cy = (int)floor(position.y / _chunkSize);
+
+	origin = Physics::toMeters(cx * _chunkSize, cy * _chunkSize);
+
+	uint64_t key = ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy;
+	auto &body = _chunks[key];
+
+	if(!body)
+		body = AddChild(New<RigidBody>(_physics.lock(), origin, 0.0f, RigidBody::Type::Static));
+
+	return body.get();
+}
+
+void StaticCollision::_addFixture(RigidBody *body, const b2Shape &shape, Object *owner,
+								  ContactMask self, ContactMask others, float friction)
+{
+	b2FixtureDef fixtureDef;
+	fixtureDef.shape = &shape;
+	fixtureDef.density = 0.1f;
+	fixtureDef.friction = friction;
+	fixtureDef.restitution = 0;
+	fixtureDef.userData = owner;
+	fixtureDef.filter.categoryBits = (uint16_t)self;
+	fixtureDef.filter.maskBits = (uint16_t)others;
+
+	body->b2_Body()->CreateFixture(&fixtureDef);
+	++_fixtureCount;
+}
+
+void StaticCollision::Add(Object *owner,
+						  const vector<shared_ptr<b2Shape>> &shapes,
+						  const vec2f &position,
+						  float angle,
+						  ContactMask self,
+						  ContactMask others,
+						  float friction)
+{
+	vec2f origin;
+	RigidBody *body = _chunk(position, origin);
+
+	// from the object's frame to the chunk body's frame
+	vec2f offset = Physics::toMeters(position) - origin;
+	b2Transform xf(b2Vec2(offset.x, offset.y), b2Rot(angle));
+
+	for(auto &shape : shapes)
+	{
+		switch(shape->GetType())
+		{
+		case b2Shape::e_circle:
+		{
+			b2CircleShape circle = *(b2CircleShape*)shape.get();
+			circle.m_p = b2Mul(xf, circle.m_p);
+
+			_addFixture(body, circle, owner, self, others, friction);
+			break;
+		}
+
+		case b2Shape::e_polygon:
+		{
+			b2PolygonShape polygon = *(b2PolygonShape*)shape.get();
+			TransformPolygon(polygon, xf);
+
+			_addFixture(body, polygon, owner, self, others, friction);
+			break;
+		}
+
+		case b2Shape::e_edge:
+		{
+			b2EdgeShape edge = *(b2EdgeShape*)shape.get();
+			edge.m_vertex1 = b2Mul(xf, edge.m_vertex1);
+			edge.m_vertex2 = b2Mul(xf, edge.m_vertex2);
+
+			_addFixture(body, edge, owner, self, others, friction);
+			break;
+		}
+
+		default:
+			break;
+		}
+	}
+}
+
+size_t StaticCollision::bodyCount() const
+{
+	return _chunks.size();
+}
+
+size_t StaticCollision::fixtureCount() const
+{
+	return _fixtureCount;
+}
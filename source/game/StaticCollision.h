@@ -0,0 +1,44 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <unordered_map>
+#include <cstdint>
+#include "Object.h"
+#include "RigidBody.h"
+
+class b2Shape;
+
+// Collision for map geometry that never moves. Instead of one static body per
+// placed object, shapes are merged into one body per square chunk of the map.
+// Each fixture keeps the object it was added for as its user data, which is
+// the object that receives OnCollisionEnter/Exit.
+class StaticCollision : public Object
+{
+	weak_ptr<Physics> _physics;
+	float _chunkSize;
+	unordered_map<uint64_t, shared_ptr<RigidBody>> _chunks;
+	size_t _fixtureCount;
+
+	RigidBody *_chunk(const vec2f &position, vec2f &origin);
+	void _addFixture(RigidBody *body, const b2Shape &shape, Object *owner,
+					 ContactMask self, ContactMask others, float friction);
+
+public:
+	StaticCollision(shared_ptr<Physics> physics, float chunkSize = 2048.0f);
+
+	// 'shapes' are in meters, see PQResImage::b2Shapes. 'position' is in
+	// pixels and 'angle' in radians, like RigidBody.
+	void Add(Object *owner,
+			 const vector<shared_ptr<b2Shape>> &shapes,
+			 const vec2f &position,
+			 float angle,
+			 ContactMask self,
+			 ContactMask others,
+			 float friction = 0.2f);
+
+	size_t bodyCount() const;
+	size_t fixtureCount() const;
+};
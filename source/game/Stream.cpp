@@ -4,7 +4,9 @@
 *--------------------------------------------------------------------------------------------*/
 
 #include "Stream.h"
+#include "Log.h"
 #include "Audio.h"
+#include "Profiler.h"
 
 void Stream::BufferCallback(void *param)
 {
@@ -20,6 +22,7 @@ Stream::Stream()
 	alive = true;
 	waitDone = false;
 	looping = false;
+	startSample = 0;
 
 	memset(buffers, 0, sizeof(ALuint) * BUFFER_COUNT);
 }
@@ -29,25 +32,65 @@ Stream::~Stream()
 	Close();
 }
 
+// fills 'samples' from the decoder, wrapping around to the start of the
+// track when looping so the seam falls inside a buffer instead of between
+// a drained queue and a reload
+int Stream::_fill(short *samples, int maxSamples)
+{
+	int count = 0;
+	bool wrapped = false;
+
+	while(count < maxSamples)
+	{
+		int n = decoder.GetSamples(samples + count, maxSamples - count);
+
+		if(n < 0)
+			return count > 0 ? count : -1;
+
+		count += n;
+
+		if(n > 0)
+			wrapped = false;
+
+		if(count < maxSamples)
+		{
+			// end of track, give up if nothing was decoded since the last wrap
+			if(!looping || wrapped)
+				break;
+
+			decoder.Seek(0);
+			wrapped = true;
+		}
+	}
+
+	return count;
+}
+
+int Stream::_format()
+{
+	return decoder.Channels() == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+}
+
 void Stream::_loadBuffers()
 {
-	decoder.Rewind();
+	decoder.Seek(startSample);
+	startSample = 0;
 
 	short sampleBuffer[BUFFER_SIZE];
 
 	int i;
 	for(i = 0; i < BUFFER_COUNT; i++)
 	{
-		int nSamples = decoder.GetSamples(sampleBuffer, BUFFER_SIZE);
-		
-		if(nSamples > 0)
-		{
-			alBufferData(buffers[i],
-						 AL_FORMAT_STEREO16,
-						 sampleBuffer,
-						 nSamples * sizeof(short),
-						 decoder.SampleRate());
-		}
+		int nSamples = _fill(sampleBuffer, BUFFER_SIZE);
+
+		if(nSamples <= 0)
+			break;
+
+		alBufferData(buffers[i],
+					 _format(),
+					 sampleBuffer,
+					 nSamples * sizeof(short),
+					 decoder.SampleRate());
 	}
 	
 	if(i <= 0)
@@ -83,6 +126,7 @@ bool Stream::Open(const char *filename)
 
 	alGenSources(1, &source);
 	alGenBuffers(BUFFER_COUNT, buffers);
+	Audio::_addStream(source);
 
 	alSource3f(source, AL_POSITION, 0.0, 0.0, 0.0);
 	alSource3f(source, AL_VELOCITY, 0.0, 0.0, 0.0);
@@ -95,6 +139,8 @@ bool Stream::Open(const char *filename)
 
 	_playerThread = thread([&]()
 	{
+		PROFILE_THREAD("Stream");
+
 		while(alive)
 		{
 			auto lk = Audio::GetLock();
@@ -106,6 +152,8 @@ bool Stream::Open(const char *filename)
 			if(!alive)
 				break;
 
+			PROFILE_ZONE("Stream::Refill");
+
 			int processed;
 			alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
 
@@ -118,12 +166,12 @@ bool Stream::Open(const char *filename)
 
 				short sampleBuffer[BUFFER_SIZE];
 
-				int nSamples = decoder.GetSamples(sampleBuffer, BUFFER_SIZE);
+				int nSamples = _fill(sampleBuffer, BUFFER_SIZE);
 				
 				if(nSamples > 0)
 				{
 					alBufferData(buffer,
-									AL_FORMAT_STEREO16,
+									_format(),
 									sampleBuffer,
 									nSamples * sizeof(short),
 									decoder.SampleRate());
@@ -139,7 +187,7 @@ bool Stream::Open(const char *filename)
 
 					if(nQueued == 0)
 					{
-						Trace("stream ended");
+						Log(LogLevel::Debug, LogCategory::Audio, "stream ended");
 						processed = 0;
 
 						if(looping)
@@ -154,7 +202,7 @@ bool Stream::Open(const char *filename)
 				else if(nSamples == -1)
 				{
 					// an error has occured while trying to decode the stream
-					Trace("stream failed to update");
+					Log(LogLevel::Warning, LogCategory::Audio, "stream failed to update");
 					break;
 				}
 			}
@@ -182,6 +230,7 @@ void Stream::Close()
 	
 	{
 		auto lk = Audio::GetLock();
+		Audio::_removeStream(source);
 		alDeleteSources(1, &source);
 		alDeleteBuffers(BUFFER_COUNT, buffers);
 	}
@@ -274,6 +323,28 @@ void Stream::SetLoop(bool loop)
 	looping = loop;
 }
 
+void Stream::Seek(float seconds)
+{
+	auto lk = Audio::GetLock();
+
+	startSample = (uint64_t)(max(seconds, 0.0f) * decoder.SampleRate());
+
+	if(!alIsSource(source)) return;
+
+	ALenum state;
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+
+	if(state == AL_PLAYING || state == AL_PAUSED)
+	{
+		alSourceStop(source);
+		_unloadBuffers();
+		_loadBuffers();
+
+		if(state == AL_PLAYING)
+			alSourcePlay(source);
+	}
+}
+
 void Stream::SetGain(float gain)
 {
 	auto lk = Audio::GetLock();
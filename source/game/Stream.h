@@ -27,15 +27,18 @@ private:
 	volatile bool alive;
 	ALuint source;
 	bool looping;
+	uint64_t startSample;
 
 	mutex m;
-	condition_variable cv;
+	condition_variable_any cv;
 	MP3Decoder decoder;
 	ALuint buffers[BUFFER_COUNT];
 	thread _playerThread;
 
 	void _loadBuffers();
 	void _unloadBuffers();
+	int _fill(short *samples, int maxSamples);
+	int _format();
 
 public:
 
@@ -55,6 +58,9 @@ public:
 	bool IsOpen();
 	
 	void SetLoop(bool loop = false);
+
+	// where the next Play() starts, or jumps there if already playing
+	void Seek(float seconds);
 	void SetGain(float gain = 1.0f);
 	float GetGain();
 
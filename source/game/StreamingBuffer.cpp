@@ -0,0 +1,272 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "StreamingBuffer.h"
+#include "Log.h"
+#include "Graphics.h"
+#include <cstring>
+
+// GL_ARB_buffer_storage is newer than the bundled GLEW
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+
+typedef void (APIENTRY *BufferStorageProc)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+
+static bool HasExtension(const char *name)
+{
+	if(!glGetStringi)
+		return false;
+
+	GLint count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+	for(GLint i = 0; i < count; ++i)
+	{
+		const char *ext = (const char*)glGetStringi(GL_EXTENSIONS, i);
+
+		if(ext && strcmp(ext, name) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+StreamingBuffer::StreamingBuffer()
+{
+	_buffer = 0;
+	_mapped = nullptr;
+	_persistent = false;
+	_rangeMapped = false;
+	_capacity = 0;
+	_head = 0;
+	_used = 0;
+	_frameBytes = 0;
+	_stalls = 0;
+}
+
+StreamingBuffer::~StreamingBuffer()
+{
+	Destroy();
+}
+
+bool StreamingBuffer::Create(uint32_t capacity)
+{
+	Destroy();
+
+	glGenBuffers(1, &_buffer);
+	Graphics::state().BindBuffer(GL_ARRAY_BUFFER, _buffer);
+
+	auto bufferStorage = (BufferStorageProc)wglGetProcAddress("glBufferStorage");
+
+	if(bufferStorage && GLEW_ARB_sync && HasExtension("GL_ARB_buffer_storage"))
+	{
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		bufferStorage(GL_ARRAY_BUFFER, capacity, nullptr, flags);
+		_mapped = (uint8_t*)glMapBufferRange(GL_ARRAY_BUFFER, 0, capacity, flags);
+
+		if(!_mapped)
+		{
+			// storage is immutable, start over with a plain buffer
+			Log(LogLevel::Warning, LogCategory::Graphics, "could not map streaming buffer persistently");
+
+			Graphics::state().InvalidateBuffer(_buffer);
+			glDeleteBuffers(1, &_buffer);
+
+			glGenBuffers(1, &_buffer);
+			Graphics::state().BindBuffer(GL_ARRAY_BUFFER, _buffer);
+		}
+	}
+
+	_persistent = _mapped != nullptr;
+
+	if(!_persistent)
+		glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+
+	_capacity = capacity;
+	_head = 0;
+	_used = 0;
+	_frameBytes = 0;
+	_stalls = 0;
+
+	return true;
+}
+
+void StreamingBuffer::Destroy()
+{
+	for(auto &frame : _frames)
+		glDeleteSync(frame.fence);
+
+	_frames.clear();
+
+	if(glIsBuffer(_buffer))
+	{
+		if(_mapped || _rangeMapped)
+		{
+			Graphics::state().BindBuffer(GL_ARRAY_BUFFER, _buffer);
+			glUnmapBuffer(GL_ARRAY_BUFFER);
+		}
+
+		Graphics::state().InvalidateBuffer(_buffer);
+		glDeleteBuffers(1, &_buffer);
+	}
+
+	_buffer = 0;
+	_mapped = nullptr;
+	_persistent = false;
+	_rangeMapped = false;
+	_capacity = 0;
+	_head = 0;
+	_used = 0;
+	_frameBytes = 0;
+}
+
+bool StreamingBuffer::_retireFrame(bool wait)
+{
+	if(_frames.empty())
+		return false;
+
+	Frame &frame = _frames.front();
+
+	GLenum result = glClientWaitSync(frame.fence, 0, 0);
+
+	if(result == GL_TIMEOUT_EXPIRED)
+	{
+		if(!wait)
+			return false;
+
+		++_stalls;
+
+		do {
+			result = glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		} while(result == GL_TIMEOUT_EXPIRED);
+	}
+
+	glDeleteSync(frame.fence);
+	_used -= frame.bytes;
+	_frames.pop_front();
+
+	return true;
+}
+
+void StreamingBuffer::_orphan()
+{
+	// the driver gives us fresh storage and frees the old one once the GPU is done with it
+	Graphics::state().BindBuffer(GL_ARRAY_BUFFER, _buffer);
+	glBufferData(GL_ARRAY_BUFFER, _capacity, nullptr, GL_STREAM_DRAW);
+
+	_head = 0;
+	_used = 0;
+	_frameBytes = 0;
+}
+
+void *StreamingBuffer::Map(uint32_t size, uint32_t alignment, StreamRange &range)
+{
+	if(!_buffer || size == 0 || size > _capacity)
+		return nullptr;
+
+	Unmap();
+
+	// give back whatever the GPU has already finished with
+	while(_retireFrame(false));
+
+	uint32_t offset;
+	uint32_t padding;
+
+	for(;;)
+	{
+		offset = (_head + alignment - 1) / alignment * alignment;
+		padding = offset - _head;
+
+		if(offset + size > _capacity)
+		{
+			if(!_persistent)
+			{
+				_orphan();
+				offset = 0;
+				padding = 0;
+				break;
+			}
+
+			// skip the tail end of the ring
+			offset = 0;
+			padding = _capacity - _head;
+		}
+
+		if(!_persistent || _used + padding + size <= _capacity)
+			break;
+
+		if(!_retireFrame(true))
+		{
+			Log(LogLevel::Warning, LogCategory::Graphics, "streaming buffer is too small for one frame");
+			return nullptr;
+		}
+	}
+
+	_head = offset + size;
+	_used += padding + size;
+	_frameBytes += padding + size;
+
+	range.buffer = _buffer;
+	range.offset = offset;
+	range.size = size;
+
+	if(_persistent)
+		return _mapped + offset;
+
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+
+	Graphics::state().BindBuffer(GL_ARRAY_BUFFER, _buffer);
+	void *p = glMapBufferRange(GL_ARRAY_BUFFER, offset, size, flags);
+
+	_rangeMapped = p != nullptr;
+
+	return p;
+}
+
+void StreamingBuffer::Unmap()
+{
+	if(_rangeMapped)
+	{
+		Graphics::state().BindBuffer(GL_ARRAY_BUFFER, _buffer);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+		_rangeMapped = false;
+	}
+}
+
+void StreamingBuffer::EndFrame()
+{
+	Unmap();
+
+	if(_persistent && _frameBytes > 0)
+	{
+		Frame frame;
+		frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		frame.bytes = _frameBytes;
+		_frames.push_back(frame);
+	}
+
+	_frameBytes = 0;
+}
+
+bool StreamingBuffer::persistent() const
+{
+	return _persistent;
+}
+
+uint32_t StreamingBuffer::bufferID() const
+{
+	return _buffer;
+}
+
+uint32_t StreamingBuffer::capacity() const
+{
+	return _capacity;
+}
+
+uint32_t StreamingBuffer::stalls() const
+{
+	return _stalls;
+}
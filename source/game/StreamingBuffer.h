@@ -0,0 +1,77 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include "includes.h"
+#include <deque>
+#include <cstdint>
+
+struct StreamRange
+{
+	StreamRange() : buffer(0), offset(0), size(0){}
+
+	GLuint buffer;
+	uint32_t offset;
+	uint32_t size;
+};
+
+// One large vertex buffer that all per-frame geometry is written into. Space is
+// handed out front to back around a ring.
+//
+// With GL_ARB_buffer_storage the buffer stays mapped for its whole life and
+// every frame is fenced, so a write only waits when the ring wraps onto a frame
+// the GPU is still reading. Without it, the buffer is orphaned when the ring
+// wraps and each range is mapped unsynchronized.
+class StreamingBuffer
+{
+public:
+	static const uint32_t DefaultCapacity = 4 * 1024 * 1024;
+
+	StreamingBuffer();
+	~StreamingBuffer();
+
+	StreamingBuffer(const StreamingBuffer&) = delete;
+	StreamingBuffer &operator=(const StreamingBuffer&) = delete;
+
+	bool Create(uint32_t capacity = DefaultCapacity);
+	void Destroy();
+
+	// write-only memory for 'size' bytes whose offset in the buffer is a multiple
+	// of 'alignment'. Must be unmapped before drawing. Returns nullptr if the
+	// request can't fit.
+	void *Map(uint32_t size, uint32_t alignment, StreamRange &range);
+	void Unmap();
+
+	// fences everything written since the last call
+	void EndFrame();
+
+	bool persistent() const;
+	uint32_t bufferID() const;
+	uint32_t capacity() const;
+
+	// number of times a write had to wait for the GPU
+	uint32_t stalls() const;
+
+private:
+	struct Frame
+	{
+		GLsync fence;
+		uint32_t bytes;
+	};
+
+	GLuint _buffer;
+	uint8_t *_mapped;
+	bool _persistent;
+	bool _rangeMapped;
+	uint32_t _capacity;
+	uint32_t _head;
+	uint32_t _used;
+	uint32_t _frameBytes;
+	uint32_t _stalls;
+	deque<Frame> _frames;
+
+	bool _retireFrame(bool wait);
+	void _orphan();
+};
@@ -5,6 +5,20 @@
 
 #include "Task.h"
 #include "Object.h"
+#include "Counters.h"
+
+static Counter liveTasks("tasks.live", Counters::Kind::Gauge);
+static Counter liveCoroutines("tasks.coroutines", Counters::Kind::Gauge);
+
+Task::Task()
+{
+	liveTasks.Add(1);
+}
+
+Task::~Task()
+{
+	liveTasks.Add(-1);
+}
 
 ////////////////////////
 
@@ -56,7 +70,12 @@ bool DelayedTask::Execute()
 CoroutineTask::CoroutineTask(const function<void(yield_token<float> yield)> &fx)
 	: routine(fx), runAt(0)
 {
+	liveCoroutines.Add(1);
+}
 
+CoroutineTask::~CoroutineTask()
+{
+	liveCoroutines.Add(-1);
 }
 
 bool CoroutineTask::Execute()
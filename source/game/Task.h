@@ -11,7 +11,8 @@ using namespace coroutines;
 class Task
 {
 public:
-	virtual ~Task(){}
+	Task();
+	virtual ~Task();
 	virtual bool Execute() = 0;
 };
 
@@ -48,5 +49,6 @@ class CoroutineTask : public Task
 	float runAt;
 public:
 	CoroutineTask(const function<void(yield_token<float> yield)> &fx);
+	~CoroutineTask();
 	virtual bool Execute() override;
 };
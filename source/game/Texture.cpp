@@ -4,9 +4,12 @@
 *--------------------------------------------------------------------------------------------*/
 
 #include "Texture.h"
+#include "Log.h"
 #include <NPng.h>
 #include "bytestream.h"
 #include "utils.h"
+#include "Graphics.h"
+#include "TextureFile.h"
 
 Texture::Texture()
 {
@@ -37,22 +40,105 @@ bool Texture::Open(const string &filename)
 {
 	Close();
 
-	NPng image;
+	TextureFile file;
+	return Decode(filename, file) && Open(file);
+}
+
+bool Texture::Decode(const string &filename, TextureFile &file)
+{
+	// a cooked texture next to the image wins unless the image is newer
+	Path cooked(filename);
+	cooked.set_extension("pqtx");
+
+	if(cooked.exists() && cooked.last_modified() >= Path(filename).last_modified())
+	{
+		if(file.Load(cooked))
+			return true;
+	}
 
 	bytestream buffer = bytestream_from_file(filename);
 
-	if(buffer.empty()
-	|| !image.LoadFromMemory((unsigned char*)buffer.data(), buffer.size()))
+	const unsigned char *data = (const unsigned char*)buffer.data();
+	unsigned int width, height;
+
+	if(buffer.empty() || !NPng::ReadSize(data, buffer.size(), width, height))
+	{
+		Log(LogLevel::Error, LogCategory::Resources, "Failed to open image", filename);
+		return false;
+	}
+
+	file.format = TextureFormat::RGBA8;
+	file.levels.resize(1);
+
+	auto &level = file.levels[0];
+	level.width = width;
+	level.height = height;
+	level.data.resize((size_t)width * height * 4);
+
+	if(!NPng::Decode(NPngContext::thread(), data, buffer.size(), level.data.data(), width, height))
 	{
-		Trace("Failed to open image: ", filename);
+		Log(LogLevel::Error, LogCategory::Resources, "Failed to open image", filename);
+		file.levels.clear();
 		return false;
 	}
 
+	return true;
+}
+
+bool Texture::Open(const TextureFile &file)
+{
+	Close();
+
+	if(file.levels.empty())
+		return false;
+
+	struct { GLint internalFormat; GLenum format; GLenum type; } layouts[] =
+	{
+		{ GL_RGBA8,   GL_RGBA, GL_UNSIGNED_BYTE },
+		{ GL_RGB5,    GL_RGB,  GL_UNSIGNED_SHORT_5_6_5 },
+		{ GL_RGB5_A1, GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1 },
+		{ GL_RGBA4,   GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4 },
+	};
+
+	auto &layout = layouts[(int)file.format];
+	int levelCount = (int)file.levels.size();
+
+	_width = file.width();
+	_height = file.height();
+
+	// decoded images come without mips, power of two ones get them from GL
+	bool doMipMaps = levelCount == 1 && IsPowerOfTwo(_width) && IsPowerOfTwo(_height);
+
+	_create(levelCount > 1 || doMipMaps);
+
+	if(!doMipMaps)
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+
+	// 16 bit rows are only 2 byte aligned
+	glPixelStorei(GL_UNPACK_ALIGNMENT, TextureFile::BytesPerPixel(file.format));
+
+	for(int i = 0; i < levelCount; ++i)
+	{
+		auto &level = file.levels[i];
+		glTexImage2D(GL_TEXTURE_2D, i, layout.internalFormat, level.width, level.height, 0, layout.format, layout.type, level.data.data());
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	if(doMipMaps)
+		glGenerateMipmap(GL_TEXTURE_2D);
+
+	_isOpen = true;
+
+	return true;
+}
+
+void Texture::_create(bool mipmapped)
+{
 	glGenTextures(1, &_textureID);
-	glBindTexture(GL_TEXTURE_2D, _textureID);
+	Graphics::state().BindTextureForEdit(_textureID);
 
-	bool doMipMaps = IsPowerOfTwo(_width) && IsPowerOfTwo(_height);
-	int minFilter = doMipMaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR;
+	int minFilter = mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR;
 	
 	GLint _gl_WrapModes[]= {
 		GL_CLAMP_TO_EDGE,
@@ -65,22 +151,15 @@ bool Texture::Open(const string &filename)
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wm);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wm);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.GetWidth(), image.GetHeight(), 0, GL_RGBA, GL_UNSIGNED_BYTE, image.GetPixels());
-
-	if(doMipMaps)
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-	_width = image.GetWidth();
-	_height = image.GetHeight();
-	_isOpen = true;
-
-	return true;
 }
 
 void Texture::Close()
 {
 	if(glIsTexture(_textureID))
+	{
+		Graphics::state().InvalidateTexture(_textureID);
 		glDeleteTextures(1, &_textureID);
+	}
 	
 	_textureID = -1;
 	_width = 0;
@@ -130,7 +209,7 @@ void Texture::wrapMode(WrapMode setWrapMode)
 
 	if(glIsTexture(_textureID))
 	{
-		glBindTexture(GL_TEXTURE_2D, _textureID);
+		Graphics::state().BindTextureForEdit(_textureID);
 
 		GLint _gl_WrapModes[]= {
 			GL_CLAMP_TO_EDGE,
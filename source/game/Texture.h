@@ -8,6 +8,8 @@
 #include "includes.h"
 #include "Path.h"
 
+class TextureFile;
+
 class Texture : public Object
 {
 public:
@@ -22,6 +24,7 @@ public:
 	~Texture();
 
 	bool Open(const string &filename);
+	bool Open(const TextureFile &file);
 	void Close();
 	bool IsOpen() const;
 	
@@ -32,6 +35,10 @@ public:
 	uint32_t channelsCount() const;
 	WrapMode wrapMode() const;
 	void wrapMode(WrapMode setWrapMode);
+
+	// loads the cooked texture, or decodes the image to RGBA8 when there is
+	// none. Doesn't touch GL, so it can run on any thread.
+	static bool Decode(const string &filename, TextureFile &file);
 protected:
 	Path _filename;
 	GLuint _textureID;
@@ -39,4 +46,6 @@ protected:
 	uint32_t _height;
 	WrapMode _wrapMode;
 	bool _isOpen;
+
+	void _create(bool mipmapped);
 };
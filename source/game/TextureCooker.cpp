@@ -0,0 +1,156 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "TextureCooker.h"
+#include "TextureFile.h"
+#include "Math.h"
+#include "Trace.h"
+#include "utils.h"
+#include <NPng.h>
+#include <Windows.h>
+#include <sstream>
+#include <algorithm>
+
+static bool IsImage(const Path &path)
+{
+	string ext = path.file_extension();
+	transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+	return ext == "png";
+}
+
+bool TextureCooker::CookFile(const Path &image, bool lossyAlpha, CookStats &stats)
+{
+	NPng png;
+
+	bytestream buffer = bytestream_from_file(image);
+
+	if(buffer.empty()
+	|| !png.LoadFromMemory((unsigned char*)buffer.data(), buffer.size()))
+	{
+		Trace("could not open image", image.str());
+		return false;
+	}
+
+	uint32_t width = png.GetWidth();
+	uint32_t height = png.GetHeight();
+	const uint8_t *pixels = png.GetPixels();
+
+	bool mipmaps = IsPowerOfTwo(width) && IsPowerOfTwo(height);
+
+	TextureFile file;
+	file.Encode(pixels, width, height, TextureFile::ChooseFormat(pixels, width, height, lossyAlpha), mipmaps);
+
+	Path cooked = image;
+	cooked.set_extension("pqtx");
+
+	if(!file.Save(cooked))
+	{
+		Trace("could not write texture", cooked.str());
+		return false;
+	}
+
+	// what the runtime used to upload: RGBA8, plus a third for generated mips
+	uint64_t raw = (uint64_t)width * height * 4;
+
+	stats.sourceBytes += buffer.size();
+	stats.rawBytes += mipmaps ? raw * 4 / 3 : raw;
+	stats.cookedBytes += file.byteSize();
+
+	return true;
+}
+
+CookStats TextureCooker::CookFolder(const Path &folder, bool lossyAlpha, bool force)
+{
+	CookStats stats;
+
+	WIN32_FIND_DATAA data;
+	HANDLE find = FindFirstFileA((folder / "*").c_str(), &data);
+
+	if(find == INVALID_HANDLE_VALUE)
+		return stats;
+
+	do
+	{
+		string name = data.cFileName;
+
+		if(name == "." || name == "..")
+			continue;
+
+		Path path = folder / name;
+
+		if(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		{
+			CookStats sub = CookFolder(path, lossyAlpha, force);
+
+			stats.cooked += sub.cooked;
+			stats.skipped += sub.skipped;
+			stats.failed += sub.failed;
+			stats.sourceBytes += sub.sourceBytes;
+			stats.rawBytes += sub.rawBytes;
+			stats.cookedBytes += sub.cookedBytes;
+			continue;
+		}
+
+		if(!IsImage(path))
+			continue;
+
+		Path cooked = path;
+		cooked.set_extension("pqtx");
+
+		if(!force && cooked.exists() && cooked.last_modified() >= path.last_modified())
+		{
+			++stats.skipped;
+			continue;
+		}
+
+		if(CookFile(path, lossyAlpha, stats))
+			++stats.cooked;
+		else
+			++stats.failed;
+	}
+	while(FindNextFileA(find, &data));
+
+	FindClose(find);
+
+	return stats;
+}
+
+bool TextureCooker::Run(const string &commandLine, int &exitCode)
+{
+	istringstream args(commandLine);
+	string arg;
+
+	if(!(args >> arg) || arg != "-cook-textures")
+		return false;
+
+	Path folder = "assets\\Images";
+	bool lossyAlpha = true;
+	bool force = false;
+
+	while(args >> arg)
+	{
+		if(arg == "-exact-alpha")
+			lossyAlpha = false;
+		else if(arg == "-lossy-alpha")
+			lossyAlpha = true;
+		else if(arg == "-force")
+			force = true;
+		else
+			folder = arg;
+	}
+
+	CookStats stats = CookFolder(folder, lossyAlpha, force);
+
+	Trace("textures cooked", stats.cooked);
+	Trace("textures up to date", stats.skipped);
+	Trace("textures failed", stats.failed);
+	Trace("source PNG MB", (float)(stats.sourceBytes / 1048576.0));
+	Trace("uncompressed upload MB", (float)(stats.rawBytes / 1048576.0));
+	Trace("cooked upload MB", (float)(stats.cookedBytes / 1048576.0));
+
+	exitCode = stats.failed ? 1 : 0;
+
+	return true;
+}
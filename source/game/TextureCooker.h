@@ -0,0 +1,39 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include "Path.h"
+#include <string>
+#include <cstdint>
+using namespace std;
+
+struct CookStats
+{
+	CookStats() : cooked(0), skipped(0), failed(0), sourceBytes(0), rawBytes(0), cookedBytes(0){}
+
+	int cooked;
+	int skipped;
+	int failed;
+	uint64_t sourceBytes;  // PNG files on disk
+	uint64_t rawBytes;     // the same images as RGBA8 with mipmaps, as they were uploaded
+	uint64_t cookedBytes;  // cooked levels, as they are uploaded now
+};
+
+// Offline conversion of PNG images into TextureFiles saved next to them with
+// a .pqtx extension. Opaque images become RGB565, images with on/off alpha
+// become RGBA5551 and power-of-two images get a full mip chain. Smooth alpha
+// becomes RGBA4444, which most sprites have and is where the memory goes;
+// -exact-alpha keeps those RGBA8 instead, at about twice the size.
+//
+// Run with: PizzaQuest.exe -cook-textures [folder] [-exact-alpha] [-force]
+class TextureCooker
+{
+public:
+	static CookStats CookFolder(const Path &folder, bool lossyAlpha, bool force);
+	static bool CookFile(const Path &image, bool lossyAlpha, CookStats &stats);
+
+	// handles the command line, returns false if it wasn't a cooker command
+	static bool Run(const string &commandLine, int &exitCode);
+};
@@ -0,0 +1,252 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "TextureFile.h"
+#include "bytestream.h"
+#include "utils.h"
+#include "Log.h"
+#include <cstring>
+#include <algorithm>
+
+static const char Magic[4] = { 'P', 'Q', 'T', 'X' };
+
+static inline uint16_t Pack(const uint8_t *p, TextureFormat format)
+{
+	// round to the nearest value at the target precision
+	#define Q(v, bits) ((uint32_t)(((v) * ((1 << (bits)) - 1) + 127) / 255))
+
+	switch(format)
+	{
+	case TextureFormat::RGB565:
+		return (uint16_t)((Q(p[0], 5) << 11) | (Q(p[1], 6) << 5) | Q(p[2], 5));
+	case TextureFormat::RGBA5551:
+		return (uint16_t)((Q(p[0], 5) << 11) | (Q(p[1], 5) << 6) | (Q(p[2], 5) << 1) | (p[3] >= 128 ? 1 : 0));
+	case TextureFormat::RGBA4444:
+		return (uint16_t)((Q(p[0], 4) << 12) | (Q(p[1], 4) << 8) | (Q(p[2], 4) << 4) | Q(p[3], 4));
+	}
+
+	#undef Q
+
+	return 0;
+}
+
+static void Convert(const uint8_t *rgba, uint32_t count, TextureFormat format, uint8_t *out)
+{
+	if(format == TextureFormat::RGBA8)
+	{
+		memcpy(out, rgba, count * 4);
+		return;
+	}
+
+	uint16_t *dst = (uint16_t*)out;
+
+	for(uint32_t i = 0; i < count; ++i)
+		dst[i] = Pack(rgba + i * 4, format);
+}
+
+static void Downsample(const uint8_t *src, uint32_t width, uint32_t height, vector<uint8_t> &dst)
+{
+	uint32_t w = max(width / 2, 1u);
+	uint32_t h = max(height / 2, 1u);
+
+	dst.resize(w * h * 4);
+
+	for(uint32_t y = 0; y < h; ++y)
+	{
+		uint32_t y0 = min(y * 2, height - 1);
+		uint32_t y1 = min(y * 2 + 1, height - 1);
+
+		for(uint32_t x = 0; x < w; ++x)
+		{
+			uint32_t x0 = min(x * 2, width - 1);
+			uint32_t x1 = min(x * 2 + 1, width - 1);
+
+			const uint8_t *a = src + (y0 * width + x0) * 4;
+			const uint8_t *b = src + (y0 * width + x1) * 4;
+			const uint8_t *c = src + (y1 * width + x0) * 4;
+			const uint8_t *d = src + (y1 * width + x1) * 4;
+
+			uint8_t *out = &dst[(y * w + x) * 4];
+
+			// average premultiplied, then divide the alpha back out
+			uint32_t alpha = a[3] + b[3] + c[3] + d[3];
+
+			for(int i = 0; i < 3; ++i)
+			{
+				if(alpha)
+					out[i] = (uint8_t)((a[i] * a[3] + b[i] * b[3] + c[i] * c[3] + d[i] * d[3] + alpha / 2) / alpha);
+				else
+					out[i] = (uint8_t)((a[i] + b[i] + c[i] + d[i] + 2) / 4);
+			}
+
+			out[3] = (uint8_t)((alpha + 2) / 4);
+		}
+	}
+}
+
+TextureFile::TextureFile()
+{
+	format = TextureFormat::RGBA8;
+}
+
+uint32_t TextureFile::BytesPerPixel(TextureFormat format)
+{
+	return format == TextureFormat::RGBA8 ? 4 : 2;
+}
+
+TextureFormat TextureFile::ChooseFormat(const uint8_t *rgba, uint32_t width, uint32_t height, bool lossyAlpha)
+{
+	bool opaque = true;
+	bool binary = true;
+
+	for(uint32_t i = 0, count = width * height; i < count; ++i)
+	{
+		uint8_t a = rgba[i * 4 + 3];
+
+		if(a != 255)
+			opaque = false;
+
+		if(a != 0 && a != 255)
+		{
+			binary = false;
+			break;
+		}
+	}
+
+	if(opaque)
+		return TextureFormat::RGB565;
+
+	if(binary)
+		return TextureFormat::RGBA5551;
+
+	return lossyAlpha ? TextureFormat::RGBA4444 : TextureFormat::RGBA8;
+}
+
+void TextureFile::Encode(const uint8_t *rgba, uint32_t width, uint32_t height, TextureFormat format, bool mipmaps)
+{
+	this->format = format;
+	levels.clear();
+
+	vector<uint8_t> current(rgba, rgba + width * height * 4);
+	vector<uint8_t> next;
+
+	for(;;)
+	{
+		Level level;
+		level.width = width;
+		level.height = height;
+		level.data.resize(width * height * BytesPerPixel(format));
+
+		Convert(current.data(), width * height, format, level.data.data());
+		levels.push_back(move(level));
+
+		if(!mipmaps || (width == 1 && height == 1))
+			break;
+
+		Downsample(current.data(), width, height, next);
+		current.swap(next);
+
+		width = max(width / 2, 1u);
+		height = max(height / 2, 1u);
+	}
+}
+
+bool TextureFile::Load(const string &filename)
+{
+	levels.clear();
+
+	bytestream input = bytestream_from_file(filename);
+
+	char magic[4];
+	uint32_t version;
+	uint32_t fmt;
+	uint32_t levelCount;
+
+	if(input.available() < 16)
+		return false;
+
+	input.read(magic, 4);
+	input >> version;
+	input >> fmt;
+	input >> levelCount;
+
+	if(memcmp(magic, Magic, 4) != 0
+	|| version != Version
+	|| fmt > (uint32_t)TextureFormat::RGBA4444
+	|| levelCount == 0 || levelCount > 32)
+	{
+		Log(LogLevel::Error, LogCategory::Resources, "invalid texture file", filename);
+		return false;
+	}
+
+	format = (TextureFormat)fmt;
+	levels.resize(levelCount);
+
+	for(auto &level : levels)
+	{
+		if(input.available() < 8)
+		{
+			Log(LogLevel::Error, LogCategory::Resources, "truncated texture file", filename);
+			levels.clear();
+			return false;
+		}
+
+		input >> level.width;
+		input >> level.height;
+
+		size_t size = (size_t)level.width * level.height * BytesPerPixel(format);
+
+		if((size_t)input.available() < size)
+		{
+			Log(LogLevel::Error, LogCategory::Resources, "truncated texture file", filename);
+			levels.clear();
+			return false;
+		}
+
+		level.data.resize(size);
+		input.read(level.data.data(), size);
+	}
+
+	return true;
+}
+
+bool TextureFile::Save(const string &filename) const
+{
+	bytestream output;
+
+	output.write(Magic, 4);
+	output << (uint32_t)Version;
+	output << (uint32_t)format;
+	output << (uint32_t)levels.size();
+
+	for(auto &level : levels)
+	{
+		output << level.width;
+		output << level.height;
+		output.write(level.data.data(), level.data.size());
+	}
+
+	return bytestream_to_file(filename, output);
+}
+
+uint32_t TextureFile::width() const
+{
+	return levels.empty() ? 0 : levels[0].width;
+}
+
+uint32_t TextureFile::height() const
+{
+	return levels.empty() ? 0 : levels[0].height;
+}
+
+size_t TextureFile::byteSize() const
+{
+	size_t size = 0;
+
+	for(auto &level : levels)
+		size += level.data.size();
+
+	return size;
+}
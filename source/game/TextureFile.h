@@ -0,0 +1,55 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+using namespace std;
+
+enum class TextureFormat : uint32_t
+{
+	RGBA8,
+	RGB565,
+	RGBA5551,
+	RGBA4444,
+};
+
+// Cooked texture written by TextureCooker and loaded by Texture. Every level
+// is stored largest first, tightly packed, in the pixel layout GL expects for
+// the format, so it can be uploaded without touching the pixels.
+class TextureFile
+{
+public:
+	static const uint32_t Version = 1;
+
+	struct Level
+	{
+		uint32_t width;
+		uint32_t height;
+		vector<uint8_t> data;
+	};
+
+	TextureFormat format;
+	vector<Level> levels;
+
+	TextureFile();
+
+	bool Load(const string &filename);
+	bool Save(const string &filename) const;
+
+	// converts 8 bit RGBA pixels, adding a box filtered mip chain when asked.
+	// Colors are weighted by alpha, so transparent texels don't darken edges.
+	void Encode(const uint8_t *rgba, uint32_t width, uint32_t height, TextureFormat format, bool mipmaps);
+
+	uint32_t width() const;
+	uint32_t height() const;
+	size_t byteSize() const;
+
+	// the smallest format that keeps the image's alpha. Smooth alpha is only
+	// reduced to 4 bits when 'lossyAlpha' is set.
+	static TextureFormat ChooseFormat(const uint8_t *rgba, uint32_t width, uint32_t height, bool lossyAlpha);
+	static uint32_t BytesPerPixel(TextureFormat format);
+};
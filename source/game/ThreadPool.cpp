@@ -0,0 +1,348 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "ThreadPool.h"
+#include "Profiler.h"
+#include <algorithm>
+
+thread_local int ThreadPool::_threadIndex = 0;
+
+ThreadPool::ThreadPool()
+{
+	_queued = 0;
+	_running = false;
+}
+
+ThreadPool::~ThreadPool()
+{
+	_stop();
+}
+
+void ThreadPool::Initialize(int workerCount)
+{
+	if(workerCount < 0)
+		workerCount = max((int)thread::hardware_concurrency() - 1, 0);
+
+	that->_stop();
+	that->_start(workerCount);
+}
+
+void ThreadPool::Terminate()
+{
+	that->_stop();
+}
+
+int ThreadPool::workerCount()
+{
+	return (int)that->_threads.size();
+}
+
+int ThreadPool::threadIndex()
+{
+	return _threadIndex;
+}
+
+void ThreadPool::_start(int workerCount)
+{
+	_queues.clear();
+
+	for(int i = 0; i <= workerCount; ++i)
+		_queues.emplace_back(new Queue());
+
+	_running = true;
+
+	for(int i = 1; i <= workerCount; ++i)
+		_threads.emplace_back(&ThreadPool::_workerLoop, this, i);
+}
+
+void ThreadPool::_stop()
+{
+	{
+		lock_guard<mutex> lk(_sleepMutex);
+		_running = false;
+	}
+
+	_wake.notify_all();
+
+	for(auto &t : _threads)
+		t.join();
+
+	_threads.clear();
+
+	// jobs still queued are run here rather than dropped, group jobs own
+	// their data and their groups wait for them. Anything they queue runs
+	// inline now that there are no workers.
+	Job job;
+
+	while(!_queues.empty() && _pop(0, job))
+		_execute(job);
+
+	_queues.clear();
+	_queued = 0;
+}
+
+void ThreadPool::_workerLoop(int index)
+{
+	_threadIndex = index;
+	PROFILE_THREAD("Worker");
+
+	Job job;
+
+	for(;;)
+	{
+		if(_pop(index, job))
+		{
+			_execute(job);
+			continue;
+		}
+
+		unique_lock<mutex> lk(_sleepMutex);
+		_wake.wait(lk, [this]{ return _queued.load() > 0 || !_running; });
+
+		if(!_running)
+			break;
+	}
+}
+
+bool ThreadPool::_pop(int index, Job &job)
+{
+	size_t count = _queues.size();
+
+	// newest job from our own queue first, it is most likely to still be in cache
+	{
+		Queue &q = *_queues[index];
+		lock_guard<mutex> lk(q.m);
+
+		if(!q.jobs.empty())
+		{
+			job = q.jobs.back();
+			q.jobs.pop_back();
+			--_queued;
+			return true;
+		}
+	}
+
+	for(size_t i = 1; i < count; ++i)
+	{
+		Queue &q = *_queues[(index + i) % count];
+		lock_guard<mutex> lk(q.m);
+
+		if(!q.jobs.empty())
+		{
+			job = q.jobs.front();
+			q.jobs.pop_front();
+			--_queued;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool ThreadPool::_popOwned(const void *owner, Job &job)
+{
+	for(auto &queue : _queues)
+	{
+		Queue &q = *queue;
+		lock_guard<mutex> lk(q.m);
+
+		for(auto it = q.jobs.rbegin(); it != q.jobs.rend(); ++it)
+		{
+			if(it->owner == owner)
+			{
+				job = *it;
+				q.jobs.erase(next(it).base());
+				--_queued;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void ThreadPool::_execute(Job &job)
+{
+	EngineContext::Scope scope(job.context);
+	job.fn(job.data, job.begin, job.end);
+
+	if(job.remaining)
+		job.remaining->fetch_sub(1, memory_order_release);
+}
+
+void ThreadPool::_submit(const Job &job)
+{
+	++_queued;
+
+	{
+		Queue &q = *_queues[_threadIndex % _queues.size()];
+		lock_guard<mutex> lk(q.m);
+		q.jobs.push_back(job);
+	}
+
+	{
+		lock_guard<mutex> lk(_sleepMutex);
+	}
+
+	_wake.notify_one();
+}
+
+bool ThreadPool::RunQueuedJob(const void *owner)
+{
+	Job job;
+
+	if(!that->_popOwned(owner, job))
+		return false;
+
+	that->_execute(job);
+	return true;
+}
+
+void ThreadPool::_parallelFor(size_t count, size_t grain, void (*fn)(void*, size_t, size_t), void *data)
+{
+	if(count == 0)
+		return;
+
+	grain = max(grain, (size_t)1);
+
+	if(_threads.empty() || _threadIndex != 0 || count <= grain)
+	{
+		fn(data, 0, count);
+		return;
+	}
+
+	size_t chunks = (count + grain - 1) / grain;
+	size_t queueCount = _queues.size();
+
+	atomic<int> remaining((int)chunks);
+	EngineContext *context = EngineContext::current();
+	_queued += (int)chunks;
+
+	for(size_t c = 0; c < chunks; ++c)
+	{
+		Job job;
+		job.fn = fn;
+		job.data = data;
+		job.begin = c * grain;
+		job.end = min(count, job.begin + grain);
+		job.remaining = &remaining;
+		job.owner = &remaining;
+		job.context = context;
+
+		Queue &q = *_queues[c % queueCount];
+		lock_guard<mutex> lk(q.m);
+		q.jobs.push_back(job);
+	}
+
+	{
+		lock_guard<mutex> lk(_sleepMutex);
+	}
+
+	_wake.notify_all();
+
+	Job job;
+
+	while(remaining.load(memory_order_acquire) > 0)
+	{
+		if(_popOwned(&remaining, job))
+			_execute(job);
+		else
+			this_thread::yield();
+	}
+}
+
+////////////////////////
+
+JobGroup::JobGroup()
+	: _remaining(0)
+{
+}
+
+JobGroup::~JobGroup()
+{
+	Wait();
+
+	// the last job may still be inside _finish()
+	lock_guard<mutex> lk(_lock);
+}
+
+void JobGroup::Run(const function<void()> &fx)
+{
+	_remaining.fetch_add(1, memory_order_relaxed);
+	_queue(fx);
+}
+
+void JobGroup::Run(const function<void()> &fx, JobGroup &after)
+{
+	_remaining.fetch_add(1, memory_order_relaxed);
+
+	{
+		lock_guard<mutex> lk(after._lock);
+
+		if(!after.done())
+		{
+			after._continuations.push_back(Continuation{ this, fx });
+			return;
+		}
+	}
+
+	_queue(fx);
+}
+
+void JobGroup::Wait()
+{
+	while(!done())
+	{
+		if(!ThreadPool::RunQueuedJob(this))
+			this_thread::yield();
+	}
+}
+
+void JobGroup::_queue(const function<void()> &fx)
+{
+	ThreadPool *pool = ThreadPool::that;
+
+	ThreadPool::Job job;
+	job.fn = &JobGroup::_runJob;
+	job.data = new GroupJob{ this, fx };
+	job.begin = 0;
+	job.end = 1;
+	job.remaining = nullptr;
+	job.owner = this;
+	job.context = EngineContext::current();
+
+	if(pool->_threads.empty())
+		pool->_execute(job);
+	else
+		pool->_submit(job);
+}
+
+void JobGroup::_runJob(void *data, size_t begin, size_t end)
+{
+	GroupJob *job = (GroupJob*)data;
+	JobGroup *group = job->group;
+
+	job->fx();
+	delete job;
+
+	group->_finish();
+}
+
+void JobGroup::_finish()
+{
+	vector<Continuation> next;
+
+	{
+		lock_guard<mutex> lk(_lock);
+
+		if(_remaining.fetch_sub(1, memory_order_acq_rel) == 1)
+			next.swap(_continuations);
+	}
+
+	// 'this' may be gone once the lock is released, the groups waiting on it
+	// are not, their counts include these jobs
+	for(auto &c : next)
+		c.group->_queue(c.fx);
+}
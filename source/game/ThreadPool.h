@@ -0,0 +1,171 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <type_traits>
+#include <functional>
+#include "Singleton.h"
+#include "EngineContext.h"
+#include <coroutine.h>
+using namespace coroutines;
+
+using namespace std;
+
+// Work-stealing pool. Every worker owns a queue and pops from the back of it,
+// idle workers steal from the front of the others. The main thread owns queue 0
+// and helps out while it waits for a ParallelFor to complete, but only with
+// that ParallelFor's chunks, so a long job can't land in the middle of a frame.
+class ThreadPool : public Singleton<ThreadPool>
+{
+public:
+	struct Job
+	{
+		void (*fn)(void *data, size_t begin, size_t end);
+		void *data;
+		size_t begin;
+		size_t end;
+		atomic<int> *remaining; // optional
+		const void *owner;      // the ParallelFor or JobGroup it belongs to
+		EngineContext *context; // of the thread that queued the job
+	};
+
+private:
+	struct Queue
+	{
+		mutex m;
+		deque<Job> jobs;
+	};
+
+	vector<unique_ptr<Queue>> _queues;
+	vector<thread> _threads;
+	mutex _sleepMutex;
+	condition_variable _wake;
+	atomic<int> _queued;
+	bool _running;
+
+	static thread_local int _threadIndex;
+
+	void _start(int workerCount);
+	void _stop();
+	void _workerLoop(int index);
+	bool _pop(int index, Job &job);
+	bool _popOwned(const void *owner, Job &job);
+	void _execute(Job &job);
+	void _parallelFor(size_t count, size_t grain, void (*fn)(void*, size_t, size_t), void *data);
+	void _submit(const Job &job);
+
+	template<class F>
+	static void _invoke(void *data, size_t begin, size_t end) {
+		(*(F*)data)(begin, end);
+	}
+
+public:
+	ThreadPool();
+	~ThreadPool();
+
+	// workerCount < 0 uses one worker per hardware thread, minus the main thread
+	static void Initialize(int workerCount = -1);
+
+	// jobs still queued when the workers stop are run on the calling thread
+	static void Terminate();
+
+	static int workerCount();
+
+	// 0 on the main thread, 1..workerCount() on pool threads
+	static int threadIndex();
+
+	// calls fx(begin, end) over [0, count) in chunks of 'grain' and returns when
+	// every chunk has run. Runs inline when the pool is not running or when
+	// called from a worker.
+	template<class FN>
+	static void ParallelFor(size_t count, size_t grain, FN &&fx)
+	{
+		typedef typename remove_reference<FN>::type F;
+		that->_parallelFor(count, grain, &_invoke<F>, (void*)&fx);
+	}
+
+	// runs one queued job of 'owner' on the calling thread, returns false if
+	// there was none
+	static bool RunQueuedJob(const void *owner);
+
+	friend class JobGroup;
+};
+
+// Jobs that are waited on together. Unlike ParallelFor, queueing them returns
+// right away, and a job can be held back until another group is done, which
+// is how dependencies between jobs are expressed.
+class JobGroup
+{
+public:
+	JobGroup();
+	~JobGroup(); // waits for the jobs still running
+
+	JobGroup(const JobGroup&) = delete;
+	JobGroup &operator=(const JobGroup&) = delete;
+
+	// jobs run inline when the pool is not running
+	void Run(const function<void()> &fx);
+
+	// queues fx once every job in 'after' has finished
+	void Run(const function<void()> &fx, JobGroup &after);
+
+	// queues fx(begin, end) over [0, count) in chunks of 'grain'
+	template<class FN>
+	void ParallelFor(size_t count, size_t grain, FN fx)
+	{
+		auto shared = make_shared<FN>(move(fx));
+		grain = grain ? grain : 1;
+
+		for(size_t begin = 0; begin < count; begin += grain)
+		{
+			size_t end = count - begin < grain ? count : begin + grain;
+			Run([shared, begin, end]{ (*shared)(begin, end); });
+		}
+	}
+
+	bool done() const {
+		return _remaining.load(memory_order_acquire) == 0;
+	}
+
+	// helps run the group's own queued jobs until it is done
+	void Wait();
+
+private:
+	struct Continuation
+	{
+		JobGroup *group;
+		function<void()> fx;
+	};
+
+	struct GroupJob
+	{
+		JobGroup *group;
+		function<void()> fx;
+	};
+
+	atomic<int> _remaining;
+	mutex _lock;
+	vector<Continuation> _continuations;
+
+	void _queue(const function<void()> &fx);
+	void _finish();
+	static void _runJob(void *data, size_t begin, size_t end);
+};
+
+// yields 'value' every frame until the group is done, so a coroutine can wait
+// for jobs without blocking the frame it runs in
+template<class T>
+void WaitFor(yield_token<T> yield, const JobGroup &group, const T &value = T())
+{
+	while(!group.done())
+		yield(value);
+}
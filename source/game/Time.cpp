@@ -20,6 +20,8 @@ Time::Time(int animation_fps, int max_fps)
 	_elapsedFrames = 0;
 	_pauseTime = 0;
 	_paused = false;
+	_fixedStep = 0;
+	_simulated = false;
 	_minFrameLength = _frequency / (long long)max_fps;
 }
 
@@ -32,6 +34,12 @@ void Time::Step()
 {
 	Time *t = that;
 
+	if(t->_fixedStep > 0)
+	{
+		Step(t->_fixedStep);
+		return;
+	}
+
 	long long _now = ticks() - t->_initTime;
 	long long _elapsed = _now - t->_then;
 	
@@ -49,6 +57,40 @@ void Time::Step()
 	}
 }
 
+void Time::Step(float deltaTime)
+{
+	Time *t = that;
+
+	t->_simulated = true;
+	t->_time += deltaTime;
+	t->_deltaTime = deltaTime;
+
+	long long _now = (long long)((double)t->_time * (double)t->_frequency);
+	t->_then = _now;
+
+	++t->_elapsedFrames;
+
+	if(_now - t->_lastFpsCalc > t->_frequency)
+	{
+		t->_fps = ++t->_elapsedFrames;
+		t->_elapsedFrames = 0;
+		t->_lastFpsCalc = _now;
+	}
+}
+
+void Time::SetFixedStep(float seconds)
+{
+	Time *t = that;
+
+	t->_fixedStep = seconds;
+	t->_simulated = seconds > 0;
+}
+
+float Time::fixedStep()
+{
+	return that->_fixedStep;
+}
+
 void Time::Pause()
 {
 	Time *t = that;
@@ -102,6 +144,10 @@ float Time::time()
 float Time::exactTime()
 {
 	Time *t = that;
+
+	if(t->_simulated)
+		return t->_time;
+
 	long long now = t->ticks() - t->_initTime;
 	return (float)((double)now / (double)t->_frequency);
 }
@@ -6,9 +6,9 @@
 #pragma once
 
 #include <cstdlib>
-#include "Singleton.h"
+#include "EngineContext.h"
 
-class Time : public Singleton<Time>
+class Time : public ContextSingleton<Time>
 {
 	long long _frequency;
 	long long _minFrameLength;
@@ -24,12 +24,24 @@ class Time : public Singleton<Time>
 	
 	long long _lastFpsCalc;
 	int _elapsedFrames;
+
+	float _fixedStep;
+	bool _simulated;
 public:
 
 	Time(int animation_fps = 16, int max_fps = 90);
 	~Time();
 	
 	static void Step();
+
+	// advances time by exactly 'deltaTime' instead of reading the clock. From
+	// then on exactTime() is the same as time(), so timing only depends on the
+	// steps taken and not on how long frames took.
+	static void Step(float deltaTime);
+
+	// every Step() advances time by 'seconds', 0 goes back to the clock
+	static void SetFixedStep(float seconds);
+	static float fixedStep();
 	static void Pause();
 	static void Resume();
 	static void Sleep(float seconds);
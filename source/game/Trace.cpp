@@ -4,37 +4,29 @@
 *--------------------------------------------------------------------------------------------*/
 
 #include "Trace.h"
+#include "Log.h"
 
-#include <Windows.h>
-#define PRINTFN(s)	   char tmp[256]; sprintf_s(tmp, "Engine: %s", s); OutputDebugStringA(tmp)
-#define PRINTFNA(s, a) char tmp[256]; OutputDebugStringA("Engine: "); sprintf_s(tmp, s, a); OutputDebugStringA(tmp)
-
-void Trace(string message)
+void Trace(const string &message)
 {
-	string msg = message + "\n";
-	PRINTFN(msg.c_str());
+	Log(LogLevel::Info, LogCategory::General, message.c_str());
 }
 
-void Trace(string message, string arg)
+void Trace(const string &message, const string &arg)
 {
-	string msg = message + ": %s\n";
-	PRINTFNA(msg.c_str(), arg.c_str());
+	Log(LogLevel::Info, LogCategory::General, message.c_str(), arg);
 }
 
-void Trace(string message, int arg)
+void Trace(const string &message, int arg)
 {
-	string msg = message + ": %i\n";
-	PRINTFNA(msg.c_str(), arg);
+	Log(LogLevel::Info, LogCategory::General, message.c_str(), arg);
 }
 
-void Trace(string message, unsigned int arg)
+void Trace(const string &message, unsigned int arg)
 {
-	string msg = message + ": %u\n";
-	PRINTFNA(msg.c_str(), arg);
+	Log(LogLevel::Info, LogCategory::General, message.c_str(), arg);
 }
 
-void Trace(string message, float arg)
+void Trace(const string &message, float arg)
 {
-	string msg = message + ": %f\n";
-	PRINTFNA(msg.c_str(), arg);
-}
\ No newline at end of file
+	Log(LogLevel::Info, LogCategory::General, message.c_str(), arg);
+}
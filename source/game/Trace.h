@@ -8,8 +8,9 @@
 #include <string>
 using std::string;
 
-void Trace(string message);
-void Trace(string message, string arg);
-void Trace(string message, int arg);
-void Trace(string message, unsigned int arg);
-void Trace(string message, float arg);
+// info level records in the general category, see Log.h
+void Trace(const string &message);
+void Trace(const string &message, const string &arg);
+void Trace(const string &message, int arg);
+void Trace(const string &message, unsigned int arg);
+void Trace(const string &message, float arg);
@@ -0,0 +1,363 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#include "VoicePool.h"
+#include "Audio.h"
+#include "Wave.h"
+#include "MP3Decoder.h"
+#include "Log.h"
+#include "Profiler.h"
+#include <AL/al.h>
+#include <AL/alc.h>
+#include <algorithm>
+
+/*****************************
+SOUND BUFFER
+*****************************/
+
+SoundBuffer::SoundBuffer()
+{
+	_ready = false;
+	_failed = false;
+	id = 0;
+	length = 0;
+}
+
+SoundBuffer::~SoundBuffer()
+{
+	_loader.Wait();
+
+	if(id && Audio::Alive())
+	{
+		auto lk = Audio::GetLock();
+		alDeleteBuffers(1, &id);
+	}
+}
+
+bool SoundBuffer::IsCompressed(const string &filename)
+{
+	size_t dot = filename.find_last_of('.');
+	if(dot == string::npos)
+		return false;
+
+	string ext = filename.substr(dot + 1);
+	transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+	return ext == "mp3";
+}
+
+bool SoundBuffer::Open(const string &filename)
+{
+	return IsCompressed(filename) ? _openMP3(filename) : _openWave(filename);
+}
+
+void SoundBuffer::OpenAsync(const string &filename)
+{
+	if(!IsCompressed(filename))
+	{
+		Open(filename);
+		return;
+	}
+
+	_loader.Run([this, filename]{
+		PROFILE_ZONE("SoundBuffer::Decode");
+
+		if(!_openMP3(filename))
+			_failed = true;
+	});
+}
+
+void SoundBuffer::_upload(int channels, int bits, const void *data, size_t size, unsigned int frequency)
+{
+	ALenum format = channels == 2
+		? (bits == 8 ? AL_FORMAT_STEREO8 : AL_FORMAT_STEREO16)
+		: (bits == 8 ? AL_FORMAT_MONO8 : AL_FORMAT_MONO16);
+
+	auto lk = Audio::GetLock();
+
+	// clear error before loading sounds
+	alGetError();
+
+	alGenBuffers(1, &id);
+	alBufferData(id, format, data, (ALsizei)size, frequency);
+
+	float bytesPerFrame = (float)(channels * bits / 8);
+	float bytesPerSecond = frequency * bytesPerFrame;
+	length = (float)size / bytesPerSecond;
+
+	_ready = true;
+}
+
+bool SoundBuffer::_openWave(const string &filename)
+{
+	// released on return, OpenAL keeps its own copy of the samples
+	Wave wave;
+
+	if(!wave.Open(filename.c_str()))
+	{
+		Log(LogLevel::Error, LogCategory::Audio, "could not open file", filename);
+		return false;
+	}
+
+	if((wave.Channels() != 1 && wave.Channels() != 2)
+	|| (wave.Bitrate() != 8 && wave.Bitrate() != 16))
+	{
+		Log(LogLevel::Error, LogCategory::Audio, "Unsupported Audio Format", filename);
+		return false;
+	}
+
+	_upload(wave.Channels(), wave.Bitrate(), wave.Data(), wave.DataSize(), wave.Frequency());
+
+	return true;
+}
+
+bool SoundBuffer::_openMP3(const string &filename)
+{
+	MP3Decoder decoder;
+
+	if(!decoder.Open(filename.c_str()))
+	{
+		Log(LogLevel::Error, LogCategory::Audio, "could not open file", filename);
+		return false;
+	}
+
+	vector<short> samples;
+	short block[8192];
+	int count;
+
+	while((count = decoder.GetSamples(block, 8192)) > 0)
+		samples.insert(samples.end(), block, block + count);
+
+	if(count < 0 || samples.empty())
+	{
+		Log(LogLevel::Error, LogCategory::Audio, "could not decode file", filename);
+		return false;
+	}
+
+	_upload(decoder.Channels(), 16, samples.data(), samples.size() * sizeof(short), decoder.SampleRate());
+
+	return true;
+}
+
+/*****************************
+VOICE POOL
+*****************************/
+
+VoicePool::VoicePool()
+{
+	_clock = 0;
+
+	SetLimit(SoundCategory::Effect, 16);
+	SetLimit(SoundCategory::Speech, 2);
+	SetLimit(SoundCategory::Loop, 6);
+	SetLimit(SoundCategory::Interface, 4);
+}
+
+VoicePool::~VoicePool()
+{
+	Destroy();
+}
+
+void VoicePool::Create(int count)
+{
+	Destroy();
+
+	ALfloat sourceOri[] = {0.0, 0.0, 1.0, 0.0, 1.0, 0.0};
+
+	count = min(count, (int)MaxVoiceCount);
+	_voices.reserve(count);
+
+	for(int i = 0; i < count; ++i)
+	{
+		Voice voice;
+		voice.generation = 0;
+		voice.started = 0;
+		voice.priority = 0;
+		voice.category = SoundCategory::Effect;
+
+		alGenSources(1, &voice.source);
+
+		if(alGetError() != AL_NO_ERROR)
+			break;
+
+		// set source position, velocity and orientation
+		alSource3f(voice.source, AL_POSITION, 0.0, 0.0, 0.0f);
+		alSource3f(voice.source, AL_VELOCITY, 0.0, 0.0, 0.0);
+		alSourcefv(voice.source, AL_DIRECTION, sourceOri);
+
+		// disable the affect of distance on volume
+		alSourcef(voice.source, AL_ROLLOFF_FACTOR, 0.0);
+		alSourcei(voice.source, AL_SOURCE_RELATIVE, AL_TRUE);
+
+		_voices.push_back(move(voice));
+	}
+}
+
+void VoicePool::Destroy()
+{
+	for(auto &voice : _voices)
+	{
+		alSourceStop(voice.source);
+		alSourcei(voice.source, AL_BUFFER, 0);
+		alDeleteSources(1, &voice.source);
+	}
+
+	_voices.clear();
+}
+
+shared_ptr<SoundBuffer> VoicePool::LoadBuffer(const string &filename)
+{
+	{
+		auto lk = Audio::GetLock();
+
+		auto it = _buffers.find(filename);
+		if(it != _buffers.end())
+		{
+			if(auto buffer = it->second.lock())
+				return buffer;
+		}
+	}
+
+	auto buffer = make_shared<SoundBuffer>();
+
+	if(SoundBuffer::IsCompressed(filename))
+		buffer->OpenAsync(filename);
+	else if(!buffer->Open(filename))
+		return nullptr;
+
+	auto lk = Audio::GetLock();
+	_buffers[filename] = buffer;
+
+	return buffer;
+}
+
+bool VoicePool::_busy(const Voice &voice) const
+{
+	if(!voice.buffer)
+		return false;
+
+	ALint state;
+	alGetSourcei(voice.source, AL_SOURCE_STATE, &state);
+
+	return state == AL_PLAYING || state == AL_PAUSED;
+}
+
+VoiceHandle VoicePool::Acquire(const shared_ptr<SoundBuffer> &buffer, SoundCategory category, int priority)
+{
+	VoiceHandle handle;
+
+	if(!buffer || !buffer->ready() || _voices.empty())
+		return handle;
+
+	bool busy[MaxVoiceCount];
+	int count = (int)_voices.size();
+	int freeIndex = -1;
+	int inCategory = 0;
+
+	for(int i = 0; i < count; ++i)
+	{
+		busy[i] = _busy(_voices[i]);
+
+		if(!busy[i] && freeIndex < 0)
+			freeIndex = i;
+		else if(busy[i] && _voices[i].category == category)
+			++inCategory;
+	}
+
+	bool atLimit = inCategory >= _limits[(int)category];
+	int index = atLimit ? -1 : freeIndex;
+
+	if(index < 0)
+	{
+		// steal the lowest priority voice, oldest first
+		for(int i = 0; i < count; ++i)
+		{
+			const Voice &voice = _voices[i];
+
+			if(!busy[i] || (atLimit && voice.category != category))
+				continue;
+
+			if(index < 0
+			|| voice.priority < _voices[index].priority
+			|| (voice.priority == _voices[index].priority && voice.started < _voices[index].started))
+			{
+				index = i;
+			}
+		}
+
+		if(index < 0 || _voices[index].priority > priority)
+			return handle;
+	}
+
+	Voice &voice = _voices[index];
+
+	alSourceStop(voice.source);
+	alSourcei(voice.source, AL_BUFFER, buffer->id);
+	alSourcef(voice.source, AL_GAIN, 1.0f);
+	alSourcef(voice.source, AL_PITCH, 1.0f);
+	alSourcei(voice.source, AL_LOOPING, AL_FALSE);
+
+	voice.buffer = buffer;
+	voice.category = category;
+	voice.priority = priority;
+	voice.started = ++_clock;
+	++voice.generation;
+
+	handle.index = index;
+	handle.generation = voice.generation;
+
+	return handle;
+}
+
+void VoicePool::Release(VoiceHandle handle)
+{
+	if(!source(handle))
+		return;
+
+	Voice &voice = _voices[handle.index];
+
+	alSourceStop(voice.source);
+	alSourcei(voice.source, AL_BUFFER, 0);
+
+	voice.buffer.reset();
+	++voice.generation;
+}
+
+ALuint VoicePool::source(VoiceHandle handle) const
+{
+	if(handle.index < 0 || handle.index >= (int)_voices.size())
+		return 0;
+
+	const Voice &voice = _voices[handle.index];
+	return voice.generation == handle.generation ? voice.source : 0;
+}
+
+void VoicePool::SetLimit(SoundCategory category, int maxVoices)
+{
+	_limits[(int)category] = maxVoices;
+}
+
+int VoicePool::limit(SoundCategory category) const
+{
+	return _limits[(int)category];
+}
+
+int VoicePool::voiceCount() const
+{
+	return (int)_voices.size();
+}
+
+int VoicePool::activeCount() const
+{
+	int count = 0;
+
+	for(auto &voice : _voices)
+	{
+		if(_busy(voice))
+			++count;
+	}
+
+	return count;
+}
@@ -0,0 +1,122 @@
+/*---------------------------------------------------------------------------------------------
+*  Copyright (c) Nicolas Jinchereau. All rights reserved.
+*  Licensed under the MIT License. See License.txt in the project root for license information.
+*--------------------------------------------------------------------------------------------*/
+
+#pragma once
+#include <memory>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <atomic>
+#include <cstdint>
+#include "ThreadPool.h"
+
+using namespace std;
+
+typedef unsigned int ALuint;
+
+enum class SoundCategory
+{
+	Effect,
+	Speech,
+	Loop,
+	Interface,
+	Count
+};
+
+// Immutable sample data uploaded to OpenAL once and shared by every Sound
+// opened from the same file. No CPU-side copy of the samples is kept after
+// the upload. MP3 files are decoded in full at load time, OpenAsync does the
+// decoding on the ThreadPool and the buffer becomes ready() when it's done,
+// or failed() if the file couldn't be decoded.
+class SoundBuffer
+{
+	atomic<bool> _ready;
+	atomic<bool> _failed;
+	JobGroup _loader;
+
+	bool _openWave(const string &filename);
+	bool _openMP3(const string &filename);
+	void _upload(int channels, int bits, const void *data, size_t size, unsigned int frequency);
+
+public:
+	ALuint id;
+	float length;
+
+	SoundBuffer();
+	~SoundBuffer();
+
+	SoundBuffer(const SoundBuffer&) = delete;
+	SoundBuffer &operator=(const SoundBuffer&) = delete;
+
+	bool Open(const string &filename);
+	void OpenAsync(const string &filename);
+
+	bool ready() const { return _ready; }
+	bool failed() const { return _failed; }
+
+	static bool IsCompressed(const string &filename);
+};
+
+struct VoiceHandle
+{
+	VoiceHandle() : index(-1), generation(0){}
+
+	int index;
+	uint32_t generation;
+};
+
+// Fixed set of OpenAL sources shared by all Sounds. When no source is free,
+// or a category is at its limit, the voice with the lowest priority is stolen,
+// oldest first. A stolen voice invalidates the handle it was acquired with.
+// Callers must hold Audio::GetLock().
+class VoicePool
+{
+	struct Voice
+	{
+		ALuint source;
+		uint32_t generation;
+		uint64_t started;
+		int priority;
+		SoundCategory category;
+		shared_ptr<SoundBuffer> buffer;
+	};
+
+	vector<Voice> _voices;
+	int _limits[(int)SoundCategory::Count];
+	uint64_t _clock;
+	unordered_map<string, weak_ptr<SoundBuffer>> _buffers;
+
+	bool _busy(const Voice &voice) const;
+
+public:
+	static const int DefaultVoiceCount = 24;
+	static const int MaxVoiceCount = 64;
+
+	VoicePool();
+	~VoicePool();
+
+	void Create(int count = DefaultVoiceCount);
+	void Destroy();
+
+	// a shared buffer for 'filename', loaded on first use. Compressed files
+	// are decoded in the background and can't be played until ready().
+	shared_ptr<SoundBuffer> LoadBuffer(const string &filename);
+
+	// binds 'buffer' to a voice. Returns an invalid handle if every candidate
+	// voice has a higher priority.
+	VoiceHandle Acquire(const shared_ptr<SoundBuffer> &buffer, SoundCategory category, int priority);
+
+	// stops the voice and makes it available again
+	void Release(VoiceHandle handle);
+
+	// the voice's source, or 0 if the handle was stolen or released
+	ALuint source(VoiceHandle handle) const;
+
+	void SetLimit(SoundCategory category, int maxVoices);
+	int limit(SoundCategory category) const;
+
+	int voiceCount() const;
+	int activeCount() const;
+};
@@ -6,7 +6,7 @@
 #include "Wave.h"
 #include "Engine.h"
 #include "utils.h"
-#include "Trace.h"
+#include "Log.h"
 
 Wave::Wave()
 {
@@ -38,13 +38,13 @@ bool Wave::Open(const char *filename)
 	
 	if(file.empty())
 	{
-		Trace("Failed to open wave file: ", filename);
+		Log(LogLevel::Error, LogCategory::Audio, "Failed to open wave file", filename);
         return false;
 	}
 
 	if(file.available() < sizeof(Header))
 	{
-		Trace("Failed to read wave header: ", filename);
+		Log(LogLevel::Error, LogCategory::Audio, "Failed to read wave header", filename);
 		return false;
 	}
 
@@ -55,7 +55,7 @@ bool Wave::Open(const char *filename)
 	{
 		if(file.available() < sizeof(ChunkInfo))
 		{
-			Trace("Invalid wave chunk info: ", filename);
+			Log(LogLevel::Error, LogCategory::Audio, "Invalid wave chunk info", filename);
 			return false;
 		}
 
@@ -68,7 +68,7 @@ bool Wave::Open(const char *filename)
 		{
 			if(file.available() < sizeof(FormatChunk))
 			{
-				Trace("Invalid format chunk size: ", filename);
+				Log(LogLevel::Error, LogCategory::Audio, "Invalid format chunk size", filename);
 				return false;
 			}
 
@@ -84,7 +84,7 @@ bool Wave::Open(const char *filename)
 		{
 			if(file.available() < sizeof(FactChunk))
 			{
-				Trace("Invalid fact chunk size: ", filename);
+				Log(LogLevel::Error, LogCategory::Audio, "Invalid fact chunk size", filename);
 				return false;
 			}
 
@@ -95,7 +95,7 @@ bool Wave::Open(const char *filename)
 		{
 			if(file.available() < info.size)
 			{
-				Trace("Invalid data chunk size: ", filename);
+				Log(LogLevel::Error, LogCategory::Audio, "Invalid data chunk size", filename);
 				return false;
 			}
 
@@ -14,6 +14,7 @@ WindowsApp::WindowsApp(const string &windowTitle, int width, int height)
 	this->screenHeight = height;
 
 	fullScreen = false;
+	audioOutput = AudioOutput::Device;
 
 	if(fullScreen == true)
 		windowStyle = WS_POPUP | WS_MAXIMIZE;
@@ -9,6 +9,7 @@
 #include "bytestream.h"
 #include "Engine.h"
 #include "Graphics.h"
+#include "AudioOutput.h"
 using namespace std;
 
 class WindowsApp
@@ -19,6 +20,7 @@ public:
 	
 	// cannot be changed after the game has started
 	bool fullScreen;
+	AudioOutput audioOutput;
 
 	string windowTitle;
 	string windowClassName;
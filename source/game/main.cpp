@@ -5,9 +5,27 @@
 
 #include "Engine.h"
 #include "PizzaQuest.h"
+#include "TextureCooker.h"
+#include "Counters.h"
+#include "Log.h"
+#include "PQBenchmark.h"
+#include "Replay.h"
 
 int CALLBACK WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow)
 {
+	Logger::Configure(lpCmdLine);
+
+	int exitCode;
+	if(TextureCooker::Run(lpCmdLine, exitCode))
+		return exitCode;
+
+	Counters::Configure(lpCmdLine);
+	Replay::Configure(lpCmdLine);
+
 	PizzaQuest app(800, 480);
+
+	if(PQBenchmark::Configure(lpCmdLine))
+		app.audioOutput = AudioOutput::Null;
+
 	return app.Run();
 }
@@ -5,6 +5,43 @@
 
 #pragma once
 #include <stdio.h>
+#include <stddef.h>
+#include <vector>
+
+// Scratch memory kept between decodes: the buffers libpng and zlib allocate
+// for every image and the row pointer table. A context must only be used by
+// one thread at a time, thread() returns one per thread.
+class NPngContext
+{
+public:
+	NPngContext();
+	~NPngContext();
+
+	// CRCs are skipped by default, the zlib stream is still validated
+	bool verifyChecksums;
+
+	static NPngContext &thread();
+
+	// libpng's allocator, reuses the smallest free block that fits
+	void *Alloc(size_t size);
+	void Free(void *ptr);
+
+private:
+	friend class NPng;
+
+	struct Block
+	{
+		void *ptr;
+		size_t size;
+		bool used;
+	};
+
+	std::vector<Block> blocks;
+	std::vector<unsigned char*> rows;
+
+	NPngContext(const NPngContext&);
+	NPngContext &operator=(const NPngContext&);
+};
 
 class NPng
 {
@@ -19,6 +56,19 @@ public:
 	bool LoadFromFile(FILE *file, long long length);
 	bool LoadFromMemory(unsigned char *data, long long length);
 	static bool SavePNG(const char *filename, unsigned int width, unsigned int height, unsigned char *buffer);
+
+	// images wider or taller than this are rejected
+	static const unsigned int MaxDimension = 16384;
+
+	// reads the image size from the header without decoding anything
+	static bool ReadSize(const unsigned char *data, long long length, unsigned int &width, unsigned int &height);
+
+	// decodes to RGBA8 into 'pixels', which must hold width * height * 4 bytes
+	// for the size ReadSize returned. Safe to call from several threads as long
+	// as each one passes its own context.
+	static bool Decode(NPngContext &context, const unsigned char *data, long long length,
+					   unsigned char *pixels, unsigned int width, unsigned int height);
+
 	void Close();
 
 	unsigned int GetWidth();
@@ -8,6 +8,9 @@
 #include <assert.h>
 #include <png.h>
 #include <string>
+#include <string.h>
+#include <stdlib.h>
+#include <new>
 
 using namespace std;
 
@@ -16,16 +19,21 @@ using namespace std;
 #define NPNG_ERROR(s) fprintf(stderr, "NPng Error: %s",  s)
 
 // custom read function for loading png files from memory
-void read_mem_data(png_structp png_ptr, png_bytep outBytes, png_size_t byteCountToRead)
+struct MemoryReader
 {
-	unsigned char **dataPtr = (unsigned char**)png_get_io_ptr(png_ptr);
+	const unsigned char *ptr;
+	const unsigned char *end;
+};
 
-	if(*dataPtr == NULL)
-		return;
+void read_mem_data(png_structp png_ptr, png_bytep outBytes, png_size_t byteCountToRead)
+{
+	MemoryReader *reader = (MemoryReader*)png_get_io_ptr(png_ptr);
 
-	memcpy(outBytes, (*dataPtr), byteCountToRead);
+	if((png_size_t)(reader->end - reader->ptr) < byteCountToRead)
+		png_error(png_ptr, "unexpected end of data");
 
-	(*dataPtr) += byteCountToRead;
+	memcpy(outBytes, reader->ptr, byteCountToRead);
+	reader->ptr += byteCountToRead;
 }
 
 NPng::NPng() : w(0), h(0), pixels(NULL)
@@ -88,6 +96,7 @@ void InitPngSettings(png_struct *pPngStruct, png_info *pPngInfo)
 		png_set_tRNS_to_alpha(pPngStruct); // expand to RGBA
 	
 	png_set_filler(pPngStruct, 0xff, PNG_FILLER_AFTER); // fill last byte of 24bit images
+	png_set_interlace_handling(pPngStruct); // png_read_image does every pass
 	png_read_update_info(pPngStruct, pPngInfo); // required for palette alterations
 }
 
@@ -154,14 +163,17 @@ bool NPng::LoadFromFile(FILE *file, long long length)
 		w = png_get_image_width(pPngStruct, pPngInfo);
 		h = png_get_image_height(pPngStruct, pPngInfo);
 
+		if(w > MaxDimension || h > MaxDimension)
+			png_error(pPngStruct, "image too large");
+
 		InitPngSettings(pPngStruct, pPngInfo);
 
-		pixels = new unsigned char[w * h * 4];
+		pixels = new unsigned char[(size_t)w * h * 4];
 		rowPtrs = new unsigned char*[h];
 		
 		for(unsigned int y = 0; y < h; y++)
 		{
-			rowPtrs[y] = pixels + (y * w * 4);
+			rowPtrs[y] = pixels + (size_t)y * w * 4;
 		}
 		
 		png_read_image(pPngStruct, rowPtrs);
@@ -196,7 +208,144 @@ bool NPng::LoadFromMemory(unsigned char *data, long long length)
 		return false;
 	}
 
-	png_struct *pPngStruct = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+	unsigned int width, height;
+
+	if(!ReadSize(data, length, width, height))
+	{
+		NPNG_ERROR("couldn't read png header.");
+		return false;
+	}
+
+	pixels = new (std::nothrow) unsigned char[(size_t)width * height * 4];
+
+	if(!pixels)
+	{
+		NPNG_ERROR("couldn't allocate the pixels.");
+		return false;
+	}
+
+	if(!Decode(NPngContext::thread(), data, length, pixels, width, height))
+	{
+		delete [] pixels;
+		pixels = NULL;
+		return false;
+	}
+
+	w = width;
+	h = height;
+
+	return true;
+}
+
+/*****************************
+CONTEXT
+*****************************/
+
+NPngContext::NPngContext()
+	: verifyChecksums(false)
+{
+}
+
+NPngContext::~NPngContext()
+{
+	for(size_t i = 0; i < blocks.size(); ++i)
+		free(blocks[i].ptr);
+}
+
+NPngContext &NPngContext::thread()
+{
+	static thread_local NPngContext context;
+	return context;
+}
+
+void *NPngContext::Alloc(size_t size)
+{
+	Block *best = NULL;
+
+	for(size_t i = 0; i < blocks.size(); ++i)
+	{
+		Block &block = blocks[i];
+
+		if(!block.used && block.size >= size && (!best || block.size < best->size))
+			best = &block;
+	}
+
+	if(best)
+	{
+		best->used = true;
+		return best->ptr;
+	}
+
+	Block block;
+	block.ptr = malloc(size);
+	block.size = size;
+	block.used = true;
+
+	if(!block.ptr)
+		return NULL;
+
+	blocks.push_back(block);
+	return block.ptr;
+}
+
+void NPngContext::Free(void *ptr)
+{
+	for(size_t i = 0; i < blocks.size(); ++i)
+	{
+		if(blocks[i].ptr == ptr)
+		{
+			blocks[i].used = false;
+			return;
+		}
+	}
+}
+
+static png_voidp context_malloc(png_structp png_ptr, png_alloc_size_t size)
+{
+	return ((NPngContext*)png_get_mem_ptr(png_ptr))->Alloc(size);
+}
+
+static void context_free(png_structp png_ptr, png_voidp ptr)
+{
+	((NPngContext*)png_get_mem_ptr(png_ptr))->Free(ptr);
+}
+
+/*****************************
+DECODING
+*****************************/
+
+bool NPng::ReadSize(const unsigned char *data, long long length, unsigned int &width, unsigned int &height)
+{
+	// signature, IHDR length and type, then the big-endian width and height
+	if(!data || length < 24 || png_sig_cmp((png_const_bytep)data, 0, PNGSIGSIZE) != 0)
+		return false;
+
+	if(memcmp(data + 12, "IHDR", 4) != 0)
+		return false;
+
+	width = png_get_uint_32(data + 16);
+	height = png_get_uint_32(data + 20);
+
+	return width > 0 && height > 0
+		&& width <= MaxDimension && height <= MaxDimension;
+}
+
+bool NPng::Decode(NPngContext &context, const unsigned char *data, long long length,
+				  unsigned char *pixels, unsigned int width, unsigned int height)
+{
+	unsigned int headerWidth, headerHeight;
+
+	if(!pixels
+	|| !ReadSize(data, length, headerWidth, headerHeight)
+	|| headerWidth != width
+	|| headerHeight != height)
+	{
+		NPNG_ERROR("couldn't read png header.");
+		return false;
+	}
+
+	png_struct *pPngStruct = png_create_read_struct_2(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL,
+													  &context, context_malloc, context_free);
 	if(!pPngStruct)
 	{
 		NPNG_ERROR("failed to initialize libpng.");
@@ -211,59 +360,47 @@ bool NPng::LoadFromMemory(unsigned char *data, long long length)
 		return false;
 	}
 
-// start reading the file
+	if(context.rows.size() < height)
+		context.rows.resize(height);
 
-	unsigned char *dataPtr = data;
-	unsigned char **rowPtrs = NULL;
+	unsigned char **rowPtrs = &context.rows[0];
 
-	// check png signature, make sure file is valid png
-	if(png_sig_cmp(dataPtr, 0, PNGSIGSIZE) != 0)
-	{
-		NPNG_ERROR("couldn't read png header.");
-		return false;
-	}
+	for(unsigned int y = 0; y < height; y++)
+		rowPtrs[y] = pixels + (size_t)y * width * 4;
+
+	MemoryReader reader;
+	reader.ptr = data + PNGSIGSIZE;
+	reader.end = data + length;
 
 	bool ret = false;
 
-	// set pointer for handling errors during loading
 	if(setjmp(png_jmpbuf(pPngStruct)) == 0)
 	{
-		png_set_read_fn(pPngStruct, &dataPtr, &read_mem_data);
+		png_set_read_fn(pPngStruct, &reader, &read_mem_data);
 		png_set_sig_bytes(pPngStruct, PNGSIGSIZE);
-		dataPtr += PNGSIGSIZE;
+
+		if(!context.verifyChecksums)
+			png_set_crc_action(pPngStruct, PNG_CRC_QUIET_USE, PNG_CRC_QUIET_USE);
+
+		// colour profiles and text are never used, don't inflate them
+		static const png_byte ignored[] = "iCCP\0iTXt\0tEXt\0zTXt";
+		png_set_keep_unknown_chunks(pPngStruct, PNG_HANDLE_CHUNK_NEVER, ignored, 4);
 
 		png_read_info(pPngStruct, pPngInfo);
-		w = png_get_image_width(pPngStruct, pPngInfo);
-		h = png_get_image_height(pPngStruct, pPngInfo);
 
 		InitPngSettings(pPngStruct, pPngInfo);
-		
-		pixels = new unsigned char[w * h * 4];
-		rowPtrs = new unsigned char*[h];
-		
-		for(unsigned int y = 0; y < h; y++)
-		{
-			rowPtrs[y] = pixels + (y * w * 4);
-		}
 
 		png_read_image(pPngStruct, rowPtrs);
 		
 		ret = true;
 	}
-	else // cleanup on error
+	else
 	{
 		NPNG_ERROR("Failed to load png file.");
-
-		if(pixels != NULL) delete [] pixels;
-		
-		pixels = NULL;
-		w = 0;
-		h = 0;
 		ret = false;
 	}
 
-	if(pPngStruct)	png_destroy_read_struct(&pPngStruct, &pPngInfo, NULL);
-	if(rowPtrs)		delete [] rowPtrs;
+	png_destroy_read_struct(&pPngStruct, &pPngInfo, NULL);
 	
 	return ret;
 }